@@ -0,0 +1,156 @@
+#include "../include/u8scan/u8scan.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace u8scan;
+
+/**
+ * @brief Best time in milliseconds of several runs of std::count_if with a predicate
+ */
+template<typename Predicate>
+double time_count_if(const std::string& input, Predicate pred, std::size_t& count) {
+    auto range = make_char_range(input);
+    double best = 0;
+    for (int run = 0; run < 5; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        count = static_cast<std::size_t>(std::count_if(range.begin(), range.end(), pred));
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (run == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Compare a std::function predicate with its functor form
+ */
+template<typename Functor>
+void compare(const std::string& name, const std::string& input,
+             const std::function<bool(const CharInfo&)>& function, Functor functor) {
+    std::size_t function_count;
+    std::size_t functor_count;
+    double function_ms = time_count_if(input, function, function_count);
+    double functor_ms = time_count_if(input, functor, functor_count);
+    double mb = static_cast<double>(input.size()) / (1024.0 * 1024.0);
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << mb / (function_ms / 1000.0) << " MB/s"
+              << std::setw(10) << mb / (functor_ms / 1000.0) << " MB/s"
+              << std::setw(8) << function_ms / functor_ms << "x"
+              << (function_count == functor_count ? "" : "  (count mismatch)") << std::endl;
+}
+
+/**
+ * @brief Benchmark: std::function predicates against the inlinable functor types
+ */
+void benchmark_predicates() {
+    std::cout << "=== Predicate Benchmark: std::function vs functor ===" << std::endl;
+
+    std::string input;
+    while (input.size() < 16 * 1024 * 1024) {
+        input += u8"The quick brown fox jumps over the lazy dog 0123456789. "
+                 u8"Ünïcödé tëxt, 世界 and emoji 🌍🚀 mixed in! ";
+    }
+    std::cout << "Input: " << input.size() / (1024 * 1024) << " MB of mixed ASCII and UTF-8" << std::endl;
+    std::cout << std::left << std::setw(22) << "count_if predicate" << std::right
+              << std::setw(15) << "std::function" << std::setw(15) << "functor" << std::setw(9) << "speedup" << std::endl;
+
+    compare("is_ascii", input, predicates::is_ascii(), predicates::is_ascii_t());
+    compare("is_digit_ascii", input, predicates::is_digit_ascii(), predicates::is_digit_ascii_t());
+    compare("is_alpha_ascii", input, predicates::is_alpha_ascii(), predicates::is_alpha_ascii_t());
+    compare("in_range", input, predicates::in_range(0x4E00, 0x9FFF), predicates::in_range_t(0x4E00, 0x9FFF));
+    compare("is_letter", input, predicates::is_letter(), predicates::is_letter_t());
+    compare("is_emoji", input, predicates::is_emoji(), predicates::is_emoji_t());
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Best time in milliseconds of several runs of a function
+ */
+template<typename Function>
+double best_time(Function function) {
+    double best = 0;
+    for (int run = 0; run < 5; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (run == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Benchmark: a lambda combining predicates against the CharClass from any_of(), and span_matching()
+ */
+void benchmark_combinators() {
+    std::cout << "=== Combinator Benchmark: lambda vs CharClass ===" << std::endl;
+
+    std::string input;
+    while (input.size() < 16 * 1024 * 1024) {
+        input += u8"The quick brown fox jumps over the lazy dog 0123456789. "
+                 u8"Ünïcödé tëxt, 世界 and emoji 🌍🚀 mixed in! snake_case_name; ";
+    }
+    double mb = static_cast<double>(input.size()) / (1024.0 * 1024.0);
+
+    auto lambda = [](const CharInfo& info) {
+        return predicates::is_digit_ascii_t()(info) || info.codepoint == '_' || info.codepoint == ';';
+    };
+    auto char_class = predicates::any_of(predicates::is_digit_ascii_t(), predicates::has_codepoint_t('_'),
+                                         predicates::has_codepoint_t(';'));
+    auto cjk = predicates::any_of(predicates::is_digit_ascii_t(), predicates::in_range_t(0x4E00, 0x9FFF));
+
+    std::size_t lambda_count = 0;
+    std::size_t class_count = 0;
+    std::size_t cjk_count = 0;
+    double lambda_ms = best_time([&]() { lambda_count = u8scan::count_if(input, lambda); });
+    double class_ms = best_time([&]() { class_count = u8scan::count_if(input, char_class); });
+    double cjk_ms = best_time([&]() { cjk_count = u8scan::count_if(input, cjk); });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "count_if, lambda:              " << std::setw(8) << mb / (lambda_ms / 1000.0) << " MB/s" << std::endl;
+    std::cout << "count_if, ASCII CharClass:     " << std::setw(8) << mb / (class_ms / 1000.0) << " MB/s  ("
+              << lambda_ms / class_ms << "x" << (lambda_count == class_count ? "" : ", count mismatch") << ")" << std::endl;
+    std::cout << "count_if, CharClass with CJK:  " << std::setw(8) << mb / (cjk_ms / 1000.0) << " MB/s  ("
+              << cjk_count << " matches)" << std::endl;
+
+    // Longest prefix inside a large set, with a long identifier-like input
+    CodepointSet identifier;
+    identifier.insert_range('a', 'z').insert_range('A', 'Z').insert_range('0', '9').insert('_')
+              .insert_range(0xC0, 0x24F).insert_range(0x4E00, 0x9FFF);
+    std::string name;
+    while (name.size() < 16 * 1024 * 1024) {
+        name += u8"snake_case_identifier_0123_Ünïcödé_世界_";
+    }
+    name += " = 1";
+    double name_mb = static_cast<double>(name.size()) / (1024.0 * 1024.0);
+    std::size_t iterator_span = 0;
+    std::size_t set_span = 0;
+    double iterator_ms = best_time([&]() {
+        auto range = make_char_range(name);
+        iterator_span = std::find_if_not(range.begin(), range.end(), identifier).position();
+    });
+    double span_ms = best_time([&]() { set_span = span_matching(name, identifier); });
+    std::cout << "find_if_not, CodepointSet:     " << std::setw(8) << name_mb / (iterator_ms / 1000.0) << " MB/s" << std::endl;
+    std::cout << "span_matching, CodepointSet:   " << std::setw(8) << name_mb / (span_ms / 1000.0) << " MB/s  ("
+              << iterator_ms / span_ms << "x" << (iterator_span == set_span ? "" : ", span mismatch") << ")" << std::endl;
+    std::cout << std::endl;
+}
+
+int main() {
+    try {
+        benchmark_predicates();
+        benchmark_combinators();
+
+        std::cout << "=== Predicate Benchmark Completed Successfully ===" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -8,13 +8,33 @@
  * - STL-compatible `CharIterator` and `CharRange` for use with standard algorithms
  * - Efficient UTF-8 and ASCII scanning, with BOM detection and handling
  * - Character property predicates (is_ascii, is_digit_ascii, is_alpha_ascii, is_alphanum_ascii, is_lowercase_ascii, is_uppercase_ascii, etc.)
- * - Character conversion functions (to_lower_ascii, to_upper_ascii) for ASCII characters
+ * - Unicode General_Category with `general_category()` and predicates (is_letter, is_digit, is_punct, is_whitespace, etc.)
+ * - Predicate combinators `any_of()`, `all_of()` and `not_()` compiling to a `CharClass` bitset for SIMD `find_if()` and `count_if()`
+ * - `CodepointSet` for large codepoint sets, with vectorized `span_matching()`
+ * - Single-pass text statistics (codepoints, sequence lengths, invalid bytes, emoji, whitespace) with `analyze()`
+ * - Unicode Script property with `script()` and per-script counts with `script_histogram()`
+ * - Byte offset to line and column mapping with `LineIndex`, built with a vectorized newline search
+ * - Character conversion functions (to_lower_ascii, to_upper_ascii) for ASCII characters and whole strings
+ * - Unicode simple case mapping with `to_lower()`, `to_upper()`, `to_lower_str()` and `to_upper_str()`
+ * - Allocation-free case-insensitive comparison and hashing with `casefold_compare()`, `casefold_equal()` and `casefold_hash()`
+ * - Unicode normalization (NFC, NFD, NFKC, NFKD) with a quick-check fast path and streaming `Normalizer`
+ * - Grapheme cluster segmentation (UAX #29) with `graphemes()` and `grapheme_count()`
+ * - Word boundary segmentation (UAX #29) with `words()` yielding zero-copy byte spans
+ * - Line break opportunities (UAX #14) with `line_breaks()` for wrapping text
  * - High-performance transformation and filtering with `transform_chars()`
  * - STL-like copy functions: `copy()`, `copy_if()`, `copy_until()`, `copy_from()`, `copy_n()`, `copy_while()`
+ * - Single-pass fused filter/map/replace processing with `pipeline()`
  * - String length calculation in Unicode code points with `length()`
  * - String access functions: `at()`, `empty()`, `front()`, `back()` with BOM-aware character-level access
- * - Custom character processing via `scan_utf8()` and `scan_ascii()`
- * - Utility: `quoted_str()` for safe quoting/escaping of strings
+ * - Vectorized truncation by character count with `prefix_bytes()` and `suffix_bytes()`
+ * - Terminal column width with `display_width()` and `truncate_to_width()`
+ * - Table-driven emoji detection with `predicates::is_emoji()` and vectorized `count_emoji()`
+ * - Multi-threaded `length()`, `count_if()` and validation over chunked ranges with `ParallelCharRange`
+ * - Custom character processing via `scan_utf8()` and `scan_ascii()`, or table-driven via `ByteActionTable`
+ * - Batch scanning of many small strings on a work-stealing thread pool with `scan_batch()`
+ * - Utility: `quoted_str()` and `unquoted_str()` for safe quoting/escaping of strings
+ * - JSON string escaping with `json_escape()` and `json_unescape()`
+ * - Replacement of ill-formed UTF-8 with U+FFFD via `sanitize_utf8()`
  *
  * ## Example Usage
  * @code
@@ -76,6 +96,32 @@
 #include <iterator>
 #include <algorithm>
 #include <stdexcept>
+#include <vector>
+#include <type_traits>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <cstring>
+
+// SIMD support: SSE2 is part of every x86-64 target, SSSE3 requires e.g. -mssse3 or -march=native.
+// Define U8SCAN_NO_SIMD to force the portable scalar code paths.
+#if !defined(U8SCAN_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define U8SCAN_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(U8SCAN_HAS_SSE2) && (defined(__SSSE3__) || defined(__AVX__))
+#define U8SCAN_HAS_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#include "u8scan_tables.h"
 
 namespace u8scan {
 
@@ -185,9 +231,33 @@ public:
     CharIterator(const std::string* str, std::size_t pos, bool utf8_mode = true, bool validate = true)
         : str_(str), pos_(pos), utf8_mode_(utf8_mode), validate_(validate), char_cached_(false) {}
     
+    // Copies do not take the decoded character along: algorithms copy the iterator for every
+    // predicate call, and copying the cached CharInfo would cost more than decoding it again
+    CharIterator(const CharIterator& other)
+        : str_(other.str_), pos_(other.pos_), utf8_mode_(other.utf8_mode_), validate_(other.validate_), char_cached_(false) {}
+    
+    CharIterator& operator=(const CharIterator& other) {
+        str_ = other.str_;
+        pos_ = other.pos_;
+        utf8_mode_ = other.utf8_mode_;
+        validate_ = other.validate_;
+        char_cached_ = false;
+        return *this;
+    }
+    
     const CharInfo& operator*() const {
         if (!char_cached_) {
-            update_current_char();
+            if (at_ascii()) {
+                // ASCII is decoded in place, so that algorithms with an inlinable predicate make no call for it
+                current_char_.start_pos = pos_;
+                current_char_.byte_count = 1;
+                current_char_.codepoint = static_cast<unsigned char>((*str_)[pos_]);
+                current_char_.is_ascii = true;
+                current_char_.is_valid_utf8 = true;
+                current_char_.is_bom = false;
+            } else {
+                current_char_ = get_char_info_impl(*str_, pos_, utf8_mode_, validate_);
+            }
             char_cached_ = true;
         }
         return current_char_;
@@ -199,7 +269,11 @@ public:
     
     CharIterator& operator++() {
         if (!char_cached_) {
-            update_current_char();
+            if (at_ascii()) {
+                ++pos_;
+                return *this;
+            }
+            current_char_ = get_char_info_impl(*str_, pos_, utf8_mode_, validate_);
         }
         pos_ += current_char_.byte_count;
         char_cached_ = false;
@@ -223,8 +297,8 @@ public:
     std::size_t position() const { return pos_; }
     
 private:
-    void update_current_char() const {
-        current_char_ = get_char_info_impl(*str_, pos_, utf8_mode_, validate_);
+    bool at_ascii() const {
+        return pos_ < str_->length() && static_cast<unsigned char>((*str_)[pos_]) < 0x80;
     }
     
     static CharInfo get_char_info_impl(const std::string& input, std::size_t pos, bool utf8_mode, bool validate);
@@ -374,6 +448,411 @@ inline BOMInfo detect_bom(const std::string& input) {
     return bom;
 }
 
+/**
+ * @brief Encode a codepoint as UTF-8 into a 4-byte buffer
+ * @return Number of bytes written (0 for codepoints beyond U+10FFFF)
+ */
+inline std::size_t encode_utf8(uint32_t cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    } else if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    } else if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    } else if (cp < 0x110000) {
+        out[0] = static_cast<char>(0xF0 | (cp >> 18));
+        out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 4;
+    }
+    return 0;
+}
+
+/**
+ * @brief Decode a well-formed UTF-8 sequence of count bytes
+ */
+inline uint32_t decode_utf8(const char* data, std::size_t count) {
+    uint32_t cp = static_cast<unsigned char>(data[0]);
+    if (count == 1) {
+        return cp;
+    }
+    cp &= 0x3Fu >> (count - 1);
+    for (std::size_t i = 1; i < count; ++i) {
+        cp = (cp << 6) | (static_cast<unsigned char>(data[i]) & 0x3Fu);
+    }
+    return cp;
+}
+
+/**
+ * @brief Length of the UTF-8 sequence starting at data[pos], checked per the Unicode standard
+ * @param valid Set to false for ill-formed sequences (overlong forms, surrogates, values above U+10FFFF, truncation)
+ * @return Sequence length, or for ill-formed input the length of its maximal subpart (at least 1)
+ */
+inline std::size_t utf8_sequence_length(const char* data, std::size_t pos, std::size_t length, bool& valid) {
+    unsigned char lead = static_cast<unsigned char>(data[pos]);
+    std::size_t needed;
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xBF;
+    if (lead < 0x80) {
+        valid = true;
+        return 1;
+    } else if (lead >= 0xC2 && lead <= 0xDF) {
+        needed = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        needed = 3;
+        if (lead == 0xE0) lower = 0xA0;
+        if (lead == 0xED) upper = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        needed = 4;
+        if (lead == 0xF0) lower = 0x90;
+        if (lead == 0xF4) upper = 0x8F;
+    } else {
+        valid = false;
+        return 1;
+    }
+
+    // Only the second byte has a restricted range, the others are plain continuation bytes
+    std::size_t count = 1;
+    for (; count < needed; ++count) {
+        if (pos + count >= length) {
+            break;
+        }
+        unsigned char byte = static_cast<unsigned char>(data[pos + count]);
+        if (byte < lower || byte > upper) {
+            break;
+        }
+        lower = 0x80;
+        upper = 0xBF;
+    }
+    valid = count == needed;
+    return count;
+}
+
+/**
+ * @brief Length of the character at data[pos] as make_char_range() decodes it: 1 for an invalid byte
+ */
+inline std::size_t decoded_sequence_length(const char* data, std::size_t pos, std::size_t length) {
+    unsigned char lead = static_cast<unsigned char>(data[pos]);
+    std::size_t needed = (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : (lead & 0xF8) == 0xF0 ? 4 : 1;
+    if (pos + needed > length) {
+        return 1;
+    }
+    for (std::size_t i = 1; i < needed; ++i) {
+        if ((static_cast<unsigned char>(data[pos + i]) & 0xC0) != 0x80) {
+            return 1;
+        }
+    }
+    return needed;
+}
+
+/**
+ * @brief Index of the lowest set bit (mask must not be zero)
+ */
+inline unsigned lowest_bit_index(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * @brief Number of set bits
+ */
+inline unsigned popcount32(uint32_t v) {
+#if defined(_MSC_VER)
+    v = v - ((v >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return static_cast<unsigned>((((v + (v >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#else
+    return static_cast<unsigned>(__builtin_popcount(v));
+#endif
+}
+
+/**
+ * @brief Set of byte values with vectorized search and counting of members in a buffer
+ *
+ * With SSSE3 membership of 16 bytes is tested at once by nibble-shuffle classification
+ * (exact for any set). With SSE2 only, sets made of at most 8 byte ranges are tested by
+ * range comparisons. Otherwise a 256-bit bitmap is used per byte.
+ */
+class ByteSet {
+private:
+    uint8_t bits_[32];
+    uint8_t low_nibbles_lo_[16];    ///< Bit h set if byte (h << 4 | l) is a member, h < 8
+    uint8_t low_nibbles_hi_[16];    ///< Bit h - 8 set if byte (h << 4 | l) is a member, h >= 8
+    unsigned char range_first_[8];
+    unsigned char range_last_[8];
+    int range_count_;               ///< Number of ranges, -1 if the set has more than 8
+
+    void add_to_tables(unsigned b) {
+        bits_[b >> 3] = static_cast<uint8_t>(bits_[b >> 3] | (1u << (b & 7)));
+        unsigned high = b >> 4;
+        if (high < 8) {
+            low_nibbles_lo_[b & 0x0F] = static_cast<uint8_t>(low_nibbles_lo_[b & 0x0F] | (1u << high));
+        } else {
+            low_nibbles_hi_[b & 0x0F] = static_cast<uint8_t>(low_nibbles_hi_[b & 0x0F] | (1u << (high - 8)));
+        }
+    }
+
+    void add_range(unsigned char first, unsigned char last) {
+        // Ranges may overlap, they are only used for membership tests
+        if (range_count_ >= 0 && range_count_ < 8) {
+            range_first_[range_count_] = first;
+            range_last_[range_count_] = last;
+            ++range_count_;
+        } else {
+            range_count_ = -1;
+        }
+    }
+
+public:
+    ByteSet() : range_count_(0) {
+        std::fill(bits_, bits_ + 32, static_cast<uint8_t>(0));
+        std::fill(low_nibbles_lo_, low_nibbles_lo_ + 16, static_cast<uint8_t>(0));
+        std::fill(low_nibbles_hi_, low_nibbles_hi_ + 16, static_cast<uint8_t>(0));
+    }
+
+    ByteSet& insert(unsigned char byte) {
+        return insert_range(byte, byte);
+    }
+
+    /// Add the bytes [first, last], nothing if first > last
+    ByteSet& insert_range(unsigned char first, unsigned char last) {
+        if (first > last) {
+            return *this;
+        }
+        for (unsigned b = first; b <= last; ++b) {
+            add_to_tables(b);
+        }
+        add_range(first, last);
+        return *this;
+    }
+
+    ByteSet& erase(unsigned char byte) {
+        if (!contains(byte)) {
+            return *this;
+        }
+        bits_[byte >> 3] = static_cast<uint8_t>(bits_[byte >> 3] & ~(1u << (byte & 7)));
+
+        // Rebuild lookup tables and merged ranges from the bitmap
+        uint8_t bits[32];
+        std::copy(bits_, bits_ + 32, bits);
+        *this = ByteSet();
+        for (unsigned b = 0; b < 256; ++b) {
+            if ((bits[b >> 3] & (1u << (b & 7))) == 0) continue;
+            unsigned last = b;
+            while (last + 1 < 256 && (bits[(last + 1) >> 3] & (1u << ((last + 1) & 7))) != 0) {
+                ++last;
+            }
+            insert_range(static_cast<unsigned char>(b), static_cast<unsigned char>(last));
+            b = last;
+        }
+        return *this;
+    }
+
+    bool contains(unsigned char byte) const {
+        return (bits_[byte >> 3] & (1u << (byte & 7))) != 0;
+    }
+
+    /**
+     * @brief Find the first member byte in data[pos, length)
+     * @return Position of the first member, or length if there is none
+     */
+    std::size_t find_first(const char* data, std::size_t pos, std::size_t length) const {
+#if defined(U8SCAN_HAS_SSSE3)
+        while (pos + 32 <= length) {
+            uint32_t first = match_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+            uint32_t second = match_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 16)));
+            uint32_t mask = first | (second << 16);
+            if (mask != 0) {
+                return pos + lowest_bit_index(mask);
+            }
+            pos += 32;
+        }
+        if (pos + 16 <= length) {
+            uint32_t mask = match_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+            if (mask != 0) {
+                return pos + lowest_bit_index(mask);
+            }
+            pos += 16;
+        }
+#elif defined(U8SCAN_HAS_SSE2)
+        if (range_count_ >= 0) {
+            while (pos + 16 <= length) {
+                uint32_t mask = match_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+                if (mask != 0) {
+                    return pos + lowest_bit_index(mask);
+                }
+                pos += 16;
+            }
+        }
+#endif
+        for (; pos < length; ++pos) {
+            if (contains(static_cast<unsigned char>(data[pos]))) {
+                return pos;
+            }
+        }
+        return length;
+    }
+
+    /**
+     * @brief Number of member bytes in data[pos, length)
+     */
+    std::size_t count(const char* data, std::size_t pos, std::size_t length) const {
+        std::size_t result = 0;
+#if defined(U8SCAN_HAS_SSSE3)
+        for (; pos + 32 <= length; pos += 32) {
+            uint32_t first = match_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+            uint32_t second = match_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 16)));
+            result += popcount32(first | (second << 16));
+        }
+#elif defined(U8SCAN_HAS_SSE2)
+        if (range_count_ >= 0) {
+            for (; pos + 16 <= length; pos += 16) {
+                result += popcount32(match_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos))));
+            }
+        }
+#endif
+        for (; pos < length; ++pos) {
+            if (contains(static_cast<unsigned char>(data[pos]))) {
+                ++result;
+            }
+        }
+        return result;
+    }
+
+private:
+#if defined(U8SCAN_HAS_SSSE3)
+    /// Bit i set if byte i of v is a member
+    uint32_t match_mask(__m128i v) const {
+        const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+        const __m128i table_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(low_nibbles_lo_));
+        const __m128i table_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(low_nibbles_hi_));
+        const __m128i high_bit_lo = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i high_bit_hi = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+        __m128i low = _mm_and_si128(v, nibble_mask);
+        __m128i high = _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask);
+        __m128i lo = _mm_and_si128(_mm_shuffle_epi8(table_lo, low), _mm_shuffle_epi8(high_bit_lo, high));
+        __m128i hi = _mm_and_si128(_mm_shuffle_epi8(table_hi, low), _mm_shuffle_epi8(high_bit_hi, high));
+        return static_cast<uint32_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(lo, hi), _mm_setzero_si128()))) & 0xFFFFu;
+    }
+#elif defined(U8SCAN_HAS_SSE2)
+    /// Bit i set if byte i of v is a member (only for sets of at most 8 ranges)
+    uint32_t match_mask(__m128i v) const {
+        __m128i hits = _mm_setzero_si128();
+        for (int r = 0; r < range_count_; ++r) {
+            __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(range_first_[r])));
+            __m128i span = _mm_set1_epi8(static_cast<char>(range_last_[r] - range_first_[r]));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(_mm_min_epu8(offset, span), offset));
+        }
+        return static_cast<uint32_t>(_mm_movemask_epi8(hits));
+    }
+#endif
+};
+
+/**
+ * @brief Index of the highest set bit (mask must not be zero)
+ */
+inline unsigned highest_bit_index(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return 31u - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+}
+
+/**
+ * @brief True for bytes that start a character, i.e. anything but 10xxxxxx
+ */
+inline bool is_lead_byte(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+}
+
+#if defined(U8SCAN_HAS_SSE2)
+/**
+ * @brief Bit i set if data[i] is a lead byte, for 32 bytes
+ */
+inline uint32_t lead_byte_mask(const char* data) {
+    // Continuation bytes are the signed values -128..-65
+    const __m128i threshold = _mm_set1_epi8(-65);
+    __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+    uint32_t lo = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(first, threshold)));
+    uint32_t hi = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(second, threshold)));
+    return lo | (hi << 16);
+}
+#endif
+
+/**
+ * @brief Position of the n-th lead byte (n >= 1) in data[pos, length), or length if there are fewer
+ */
+inline std::size_t find_nth_lead_byte(const char* data, std::size_t pos, std::size_t length, std::size_t n) {
+#if defined(U8SCAN_HAS_SSE2)
+    while (pos + 32 <= length) {
+        uint32_t mask = lead_byte_mask(data + pos);
+        std::size_t count = popcount32(mask);
+        if (n > count) {
+            n -= count;
+            pos += 32;
+            continue;
+        }
+        for (; n > 1; --n) {
+            mask &= mask - 1;
+        }
+        return pos + lowest_bit_index(mask);
+    }
+#endif
+    for (; pos < length; ++pos) {
+        if (is_lead_byte(data[pos]) && --n == 0) {
+            return pos;
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief Position of the n-th lead byte (n >= 1) counting back from end in data[start, end), or start if there are fewer
+ */
+inline std::size_t rfind_nth_lead_byte(const char* data, std::size_t start, std::size_t end, std::size_t n) {
+#if defined(U8SCAN_HAS_SSE2)
+    while (end >= start + 32) {
+        uint32_t mask = lead_byte_mask(data + end - 32);
+        std::size_t count = popcount32(mask);
+        if (n > count) {
+            n -= count;
+            end -= 32;
+            continue;
+        }
+        for (;;) {
+            unsigned index = highest_bit_index(mask);
+            if (--n == 0) {
+                return end - 32 + index;
+            }
+            mask &= ~(1u << index);
+        }
+    }
+#endif
+    while (end > start) {
+        --end;
+        if (is_lead_byte(data[end]) && --n == 0) {
+            return end;
+        }
+    }
+    return start;
+}
+
 } // namespace details
 
 /**
@@ -392,18 +871,18 @@ inline std::string bom_str() {
     return "\xEF\xBB\xBF";
 }
 
+namespace details {
+
 /**
- * @brief Simplified and minimal UTF-8 scanner
- * Main entry point - automatically handles BOM and provides character-by-character processing
+ * @brief UTF-8 scanning loop appending to an existing output buffer
  */
 template<typename Processor>
-inline std::string scan_utf8(const std::string& input, Processor processor) {
-    std::string result;
-    BOMInfo bom_info = details::detect_bom(input);
+inline void scan_utf8_append(const std::string& input, Processor& processor, std::string& result) {
+    BOMInfo bom_info = detect_bom(input);
     std::size_t pos = bom_info.found ? 3 : 0;  // Skip BOM if found
     
     while (pos < input.length()) {
-        CharInfo char_info = details::extract_char_info(input, pos, true, true);
+        CharInfo char_info = extract_char_info(input, pos, true, true);
         if (pos >= input.length()) break;  // Safety check
         
         ProcessResult proc_result = processor(char_info, input.data() + pos);
@@ -418,12 +897,140 @@ inline std::string scan_utf8(const std::string& input, Processor processor) {
             case ScanAction::IGNORE:
                 break;
             case ScanAction::STOP_SCANNING:
-                return result;
+                return;
         }
         
         pos += char_info.byte_count;
     }
-    
+}
+
+} // namespace details
+
+/**
+ * @brief Simplified and minimal UTF-8 scanner
+ * Main entry point - automatically handles BOM and provides character-by-character processing
+ */
+template<typename Processor>
+inline std::string scan_utf8(const std::string& input, Processor processor) {
+    std::string result;
+    details::scan_utf8_append(input, processor, result);
+    return result;
+}
+
+/**
+ * @brief Table of scan actions for each byte value, an alternative to a processor lambda
+ *
+ * All bytes are copied by default. Actions are applied per byte: since every byte of a
+ * multi-byte UTF-8 sequence is >= 0x80, actions set on ASCII bytes never split characters.
+ * An action set on a byte >= 0x80 applies to that byte wherever it occurs, also as the lead or
+ * a continuation byte of a multi-byte character, e.g. `ignore_range(0x80, 0xFF)` drops all
+ * non-ASCII characters while `replace(0xE4, "?")` leaves the rest of a sequence behind.
+ *
+ * @code
+ * u8scan::ByteActionTable table;
+ * table.replace('"', "\\\"").replace('\\', "\\\\").ignore_range(0x00, 0x1F);
+ * std::string escaped = u8scan::scan_utf8(input, table);
+ * @endcode
+ */
+class ByteActionTable {
+private:
+    ScanAction actions_[256];
+    std::string replacements_[256];
+    details::ByteSet special_;      ///< Bytes with an action other than COPY_TO_OUTPUT
+
+public:
+    ByteActionTable() {
+        std::fill(actions_, actions_ + 256, ScanAction::COPY_TO_OUTPUT);
+    }
+
+    ByteActionTable& set(unsigned char byte, ScanAction action, const std::string& replacement = std::string()) {
+        actions_[byte] = action;
+        replacements_[byte] = replacement;
+        if (action == ScanAction::COPY_TO_OUTPUT) {
+            special_.erase(byte);
+        } else {
+            special_.insert(byte);
+        }
+        return *this;
+    }
+
+    /// Set the action of the bytes [first, last], nothing if first > last
+    ByteActionTable& set_range(unsigned char first, unsigned char last, ScanAction action, const std::string& replacement = std::string()) {
+        if (first > last) {
+            return *this;
+        }
+        for (unsigned b = first; b <= last; ++b) {
+            actions_[b] = action;
+            replacements_[b] = replacement;
+            if (action == ScanAction::COPY_TO_OUTPUT) {
+                special_.erase(static_cast<unsigned char>(b));
+            }
+        }
+        if (action != ScanAction::COPY_TO_OUTPUT) {
+            special_.insert_range(first, last);
+        }
+        return *this;
+    }
+
+    ByteActionTable& replace(unsigned char byte, const std::string& replacement) {
+        return set(byte, ScanAction::REPLACE, replacement);
+    }
+
+    ByteActionTable& ignore(unsigned char byte) {
+        return set(byte, ScanAction::IGNORE);
+    }
+
+    ByteActionTable& ignore_range(unsigned char first, unsigned char last) {
+        return set_range(first, last, ScanAction::IGNORE);
+    }
+
+    ByteActionTable& stop_at(unsigned char byte) {
+        return set(byte, ScanAction::STOP_SCANNING);
+    }
+
+    ScanAction action(unsigned char byte) const { return actions_[byte]; }
+    const std::string& replacement(unsigned char byte) const { return replacements_[byte]; }
+
+    /**
+     * @brief Find the first byte in data[pos, length) whose action is not COPY_TO_OUTPUT
+     */
+    std::size_t find_special(const char* data, std::size_t pos, std::size_t length) const {
+        return special_.find_first(data, pos, length);
+    }
+};
+
+/**
+ * @brief Table-driven UTF-8 scanner
+ *
+ * When actions are set only on ASCII bytes, produces the same output as `scan_utf8()` with a
+ * processor applying the table actions; actions on bytes >= 0x80 work on single bytes, see
+ * ByteActionTable. Bytes that are copied unchanged are skipped with a vectorized search (32
+ * bytes per step with SSSE3) and appended in bulk.
+ */
+inline std::string scan_utf8(const std::string& input, const ByteActionTable& table) {
+    std::string result;
+    result.reserve(input.length());
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t pos = details::detect_bom(input).found ? 3 : 0;
+    std::size_t run_start = pos;
+
+    while ((pos = table.find_special(data, pos, length)) < length) {
+        result.append(data + run_start, pos - run_start);
+        unsigned char byte = static_cast<unsigned char>(data[pos]);
+        switch (table.action(byte)) {
+            case ScanAction::REPLACE:
+                result += table.replacement(byte);
+                break;
+            case ScanAction::STOP_SCANNING:
+                return result;
+            case ScanAction::COPY_TO_OUTPUT:
+            case ScanAction::IGNORE:
+                break;
+        }
+        run_start = ++pos;
+    }
+    result.append(data + run_start, length - run_start);
     return result;
 }
 
@@ -542,8 +1149,34 @@ inline CharRange make_char_range(const std::string& str, std::size_t start, std:
     return CharRange(str, start, end, utf8_mode, validate, skip_bom);
 }
 
+namespace details {
+
+/**
+ * @brief Set of the ASCII bytes among up to three quoting characters
+ *
+ * A byte >= 0x80 is never a character of its own in UTF-8, so non-ASCII delimiter or escape
+ * characters match nothing, as in a per-character scan, instead of bytes inside sequences.
+ */
+inline ByteSet ascii_quote_set(char first, char second, char third) {
+    ByteSet set;
+    const char chars[3] = {first, second, third};
+    for (char c : chars) {
+        if (static_cast<unsigned char>(c) < 0x80) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+    }
+    return set;
+}
+
+} // namespace details
+
 /**
- * @brief STL-only quoted_str implementation
+ * @brief Quote a string, escaping delimiter and escape characters
+ *
+ * Delimiters and the escape character are located with a vectorized byte search and everything
+ * between them (including multi-byte characters) is copied in bulk. Only ASCII delimiter and
+ * escape characters are escaped; a non-ASCII one would otherwise match bytes inside multi-byte
+ * characters. A BOM at the start of the input is not copied.
  */
 inline std::string quoted_str(const std::string& input, char start_delim = '"', char end_delim = '"', char escape = '\\') {
     std::string result;
@@ -552,21 +1185,19 @@ inline std::string quoted_str(const std::string& input, char start_delim = '"',
     // Add start delimiter
     result += start_delim;
     
-    auto char_range = make_char_range(input);
+    details::ByteSet specials = details::ascii_quote_set(start_delim, end_delim, escape);
     
-    // Use STL transform to process each character
-    std::for_each(char_range.begin(), char_range.end(), [&](const CharInfo& info) {
-        if (info.is_ascii) {
-            char c = static_cast<char>(info.codepoint);
-            if (c == start_delim || c == end_delim || c == escape) {
-                result += escape;  // Add escape character
-            }
-            result += c;
-        } else {
-            // Add multi-byte UTF-8 character as-is 
-            result.append(input, info.start_pos, info.byte_count);
-        }
-    });
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t pos = details::detect_bom(input).found ? 3 : 0;
+    std::size_t run_start = pos;
+    
+    while ((pos = specials.find_first(data, pos, length)) < length) {
+        result.append(data + run_start, pos - run_start);
+        result += escape;  // Add escape character
+        run_start = pos++;
+    }
+    result.append(data + run_start, length - run_start);
     
     // Add end delimiter
     result += end_delim;
@@ -574,47 +1205,416 @@ inline std::string quoted_str(const std::string& input, char start_delim = '"',
 }
 
 /**
- * @brief Get information about a UTF-8 character at a specific position
+ * @brief Reverse of `quoted_str()`: remove delimiters and escape characters
+ * @param input Quoted string, e.g. produced by `quoted_str()`
+ * @return Unquoted content
+ *
+ * A leading start delimiter is skipped and the content ends at the first unescaped end
+ * delimiter (anything after it is ignored). An escape character followed by a delimiter or
+ * escape character produces that character; followed by any other byte it is dropped and the
+ * byte is kept. The escape character may be the same as the delimiters (SQL-style `'it''s'`).
+ * Input without a start or end delimiter is accepted. As in quoted_str(), only ASCII delimiter
+ * and escape characters are recognized.
+ *
+ * @code
+ * std::string text = u8scan::unquoted_str("\"A\\\"B世界\"");   // A"B世界
+ * @endcode
  */
-inline CharInfo get_char_info(const std::string& input, std::size_t pos, bool validate_utf8 = true) {
-    return details::extract_char_info(input, pos, true, validate_utf8);
+inline std::string unquoted_str(const std::string& input, char start_delim = '"', char end_delim = '"', char escape = '\\') {
+    std::string result;
+    result.reserve(input.length());
+    
+    details::ByteSet specials = details::ascii_quote_set(end_delim, escape, escape);
+    
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t pos = details::detect_bom(input).found ? 3 : 0;
+    if (pos < length && data[pos] == start_delim && static_cast<unsigned char>(start_delim) < 0x80) {
+        ++pos;
+    }
+    std::size_t run_start = pos;
+    
+    while ((pos = specials.find_first(data, pos, length)) < length) {
+        result.append(data + run_start, pos - run_start);
+        char c = data[pos];
+        bool has_next = pos + 1 < length;
+        char next = has_next ? data[pos + 1] : '\0';
+        if (c == escape && has_next && (next == start_delim || next == end_delim || next == escape)) {
+            result += next;                 // Escaped special character
+            pos += 2;
+        } else if (c == end_delim) {
+            return result;                  // Closing delimiter
+        } else if (has_next) {
+            result += next;                 // Escape before an ordinary byte is dropped
+            pos += 2;
+        } else {
+            result += c;                    // Trailing escape character is kept
+            pos += 1;
+        }
+        run_start = pos;
+    }
+    result.append(data + run_start, length - run_start);
+    return result;
 }
 
+namespace details {
+
 /**
- * @brief High-performance character transformation
+ * @brief Bytes that json_escape() cannot copy unchanged
  */
-template<typename OutputIt, typename Transformer>
-inline OutputIt transform_chars(const std::string& input, OutputIt result, Transformer transformer) {
-    auto range = make_char_range(input);
-    return std::transform(range.begin(), range.end(), result, transformer);
+inline const ByteSet& json_escape_set(bool escape_non_ascii) {
+    static const ByteSet ascii_specials = ByteSet().insert_range(0x00, 0x1F).insert('"').insert('\\');
+    static const ByteSet all_specials = ByteSet(ascii_specials).insert_range(0x80, 0xFF);
+    return escape_non_ascii ? all_specials : ascii_specials;
 }
 
 /**
- * @brief STL-like copy function - copies all characters
+ * @brief Append a \uXXXX escape with lowercase hex digits
  */
-template<typename OutputIt>
-inline OutputIt copy(const std::string& input, OutputIt result) {
-    auto range = make_char_range(input);
-    for (const auto& char_info : range) {
-        std::string char_str = input.substr(char_info.start_pos, char_info.byte_count);
-        result = std::copy(char_str.begin(), char_str.end(), result);
-    }
+inline void append_json_u_escape(std::string& result, uint32_t unit) {
+    static const char hex[] = "0123456789abcdef";
+    char buffer[6] = {'\\', 'u', hex[(unit >> 12) & 0xF], hex[(unit >> 8) & 0xF], hex[(unit >> 4) & 0xF], hex[unit & 0xF]};
+    result.append(buffer, 6);
+}
+
+/**
+ * @brief Parse 4 hex digits at data[pos]
+ * @return The value, or -1 if there are fewer than 4 hex digits
+ */
+inline long parse_hex4(const std::string& input, std::size_t pos) {
+    if (pos + 4 > input.length()) {
+        return -1;
+    }
+    long value = 0;
+    for (std::size_t i = pos; i < pos + 4; ++i) {
+        char c = input[i];
+        int digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return -1;
+        value = value * 16 + digit;
+    }
+    return value;
+}
+
+} // namespace details
+
+/**
+ * @brief Escape a UTF-8 string for use inside a JSON string literal
+ * @param input The UTF-8 string to escape (without surrounding quotes)
+ * @param escape_non_ascii Write non-ASCII characters as \uXXXX escapes (surrogate pairs above U+FFFF)
+ * @return The escaped string, without surrounding quotes
+ *
+ * Quotes, backslashes and control characters are escaped, using the short forms \b \f \n \r \t
+ * where JSON has them. Bytes that need no escaping are located with a vectorized search and copied
+ * in bulk. Non-ASCII bytes are copied unchanged unless escape_non_ascii is set, in which case
+ * each ill-formed sequence (including overlong forms and encoded surrogates) is written as one
+ * \ufffd. A leading BOM is skipped.
+ *
+ * @code
+ * std::string json = "{\"name\": \"" + u8scan::json_escape(u8"Tab\there \"世界\"") + "\"}";
+ * // {"name": "Tab\there \"世界\""}
+ * std::string ascii = u8scan::json_escape(u8"ü🌍", true);  // \u00fc\ud83c\udf0d
+ * @endcode
+ */
+inline std::string json_escape(const std::string& input, bool escape_non_ascii = false) {
+    const details::ByteSet& specials = details::json_escape_set(escape_non_ascii);
+    std::string result;
+    result.reserve(input.length() + 16);
+
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t pos = details::detect_bom(input).found ? 3 : 0;
+    std::size_t run_start = pos;
+
+    while ((pos = specials.find_first(data, pos, length)) < length) {
+        result.append(data + run_start, pos - run_start);
+        unsigned char byte = static_cast<unsigned char>(data[pos]);
+        if (byte >= 0x80) {
+            bool valid;
+            std::size_t count = details::utf8_sequence_length(data, pos, length, valid);
+            uint32_t codepoint = valid ? details::decode_utf8(data + pos, count) : 0xFFFD;
+            if (codepoint >= 0x10000) {
+                uint32_t offset = codepoint - 0x10000;
+                details::append_json_u_escape(result, 0xD800 + (offset >> 10));
+                details::append_json_u_escape(result, 0xDC00 + (offset & 0x3FF));
+            } else {
+                details::append_json_u_escape(result, codepoint);
+            }
+            pos += count;
+        } else {
+            switch (byte) {
+                case '"':  result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\b': result += "\\b"; break;
+                case '\f': result += "\\f"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default:   details::append_json_u_escape(result, byte); break;
+            }
+            ++pos;
+        }
+        run_start = pos;
+    }
+    result.append(data + run_start, length - run_start);
+    return result;
+}
+
+/**
+ * @brief Decode the escape sequences of a JSON string literal
+ * @param input Content of a JSON string literal (without surrounding quotes)
+ * @return The decoded UTF-8 string
+ *
+ * Handles all JSON escapes, including \uXXXX surrogate pairs which are recombined into a single
+ * 4-byte character. Escapes are located with a vectorized byte search; the text between them is
+ * copied in bulk. Unpaired surrogates are decoded as U+FFFD, malformed escapes are copied unchanged.
+ *
+ * @code
+ * std::string text = u8scan::json_unescape("Tab\\there \\u4e16\\ud83c\\udf0d");  // u8"Tab\there 世🌍"
+ * @endcode
+ */
+inline std::string json_unescape(const std::string& input) {
+    std::string result;
+    result.reserve(input.length());
+
+    std::size_t length = input.length();
+    std::size_t pos = 0;
+    std::size_t run_start = 0;
+
+    while ((pos = input.find('\\', pos)) != std::string::npos && pos + 1 < length) {
+        result.append(input, run_start, pos - run_start);
+        char c = input[pos + 1];
+        std::size_t consumed = 2;
+        switch (c) {
+            case '"':  result += '"'; break;
+            case '\\': result += '\\'; break;
+            case '/':  result += '/'; break;
+            case 'b':  result += '\b'; break;
+            case 'f':  result += '\f'; break;
+            case 'n':  result += '\n'; break;
+            case 'r':  result += '\r'; break;
+            case 't':  result += '\t'; break;
+            case 'u': {
+                long unit = details::parse_hex4(input, pos + 2);
+                if (unit < 0) {
+                    result.append(input, pos, 2);
+                    break;
+                }
+                consumed = 6;
+                uint32_t cp = static_cast<uint32_t>(unit);
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    long low = (pos + 7 < length && input[pos + 6] == '\\' && input[pos + 7] == 'u')
+                        ? details::parse_hex4(input, pos + 8) : -1;
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<uint32_t>(low) - 0xDC00);
+                        consumed = 12;
+                    } else {
+                        cp = 0xFFFD;
+                    }
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    cp = 0xFFFD;
+                }
+                char buffer[4];
+                result.append(buffer, details::encode_utf8(cp, buffer));
+                break;
+            }
+            default:
+                result.append(input, pos, 2);
+                break;
+        }
+        pos += consumed;
+        run_start = pos;
+    }
+    result.append(input, run_start, length - run_start);
+    return result;
+}
+
+namespace details {
+
+/**
+ * @brief Position of the first non-ASCII byte in data[pos, length), or length if there is none
+ */
+inline std::size_t skip_ascii(const char* data, std::size_t pos, std::size_t length) {
+#if defined(U8SCAN_HAS_SSE2)
+    for (; pos + 16 <= length; pos += 16) {
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos))));
+        if (mask != 0) {
+            return pos + lowest_bit_index(mask);
+        }
+    }
+#endif
+    while (pos < length && static_cast<unsigned char>(data[pos]) < 0x80) {
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * @brief Position of the first ill-formed byte in data[pos, length), or length if the data is valid
+ */
+inline std::size_t find_invalid_utf8(const char* data, std::size_t pos, std::size_t length) {
+    while ((pos = skip_ascii(data, pos, length)) < length) {
+        bool valid;
+        std::size_t count = utf8_sequence_length(data, pos, length, valid);
+        if (!valid) {
+            return pos;
+        }
+        pos += count;
+    }
+    return length;
+}
+
+} // namespace details
+
+/**
+ * @brief Replace ill-formed UTF-8 with U+FFFD
+ * @param input The string to sanitize
+ * @param out Buffer receiving the sanitized string when input is not valid UTF-8 (must not be input)
+ * @return input itself if it is valid UTF-8, otherwise out
+ *
+ * Each maximal subpart of an ill-formed sequence is replaced by one U+FFFD, as required by the
+ * WHATWG Encoding standard: overlong forms, surrogates, values above U+10FFFF, stray continuation
+ * bytes and truncated sequences are all rejected. ASCII is skipped 16 bytes at a time and valid
+ * spans are copied with a single append. Valid input is returned without copying or allocating.
+ * A BOM is valid UTF-8 and is kept.
+ *
+ * @code
+ * std::string buffer;
+ * const std::string& clean = u8scan::sanitize_utf8(untrusted, buffer);
+ * // "a\xF0\x9F\x8Cz" -> "a\xEF\xBF\xBDz" (one U+FFFD for the truncated 4-byte sequence)
+ * @endcode
+ */
+inline const std::string& sanitize_utf8(const std::string& input, std::string& out) {
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t pos = details::find_invalid_utf8(data, 0, length);
+    if (pos == length) {
+        return input;
+    }
+
+    out.clear();
+    out.reserve(length + 8);
+    std::size_t run_start = 0;
+    while (pos < length) {
+        out.append(data + run_start, pos - run_start);
+        out += "\xEF\xBF\xBD";
+        bool valid;
+        pos += details::utf8_sequence_length(data, pos, length, valid);
+        run_start = pos;
+        pos = details::find_invalid_utf8(data, pos, length);
+    }
+    out.append(data + run_start, length - run_start);
+    return out;
+}
+
+/**
+ * @brief Copy of input with ill-formed UTF-8 replaced by U+FFFD
+ */
+inline std::string sanitize_utf8(const std::string& input) {
+    std::string buffer;
+    if (&sanitize_utf8(input, buffer) == &input) {
+        return input;
+    }
+    return buffer;
+}
+
+/**
+ * @brief Get information about a UTF-8 character at a specific position
+ */
+inline CharInfo get_char_info(const std::string& input, std::size_t pos, bool validate_utf8 = true) {
+    return details::extract_char_info(input, pos, true, validate_utf8);
+}
+
+/**
+ * @brief High-performance character transformation
+ */
+template<typename OutputIt, typename Transformer>
+inline OutputIt transform_chars(const std::string& input, OutputIt result, Transformer transformer) {
+    auto range = make_char_range(input);
+    return std::transform(range.begin(), range.end(), result, transformer);
+}
+
+namespace details {
+
+/**
+ * @brief Copies a run of bytes to an output iterator
+ */
+template<typename OutputIt>
+inline OutputIt copy_bytes(const char* first, const char* last, OutputIt result) {
+    return std::copy(first, last, result);
+}
+
+/**
+ * @brief Gives access to the string behind a std::back_insert_iterator
+ */
+struct StringInserterAccess : std::back_insert_iterator<std::string> {
+    static std::string& container_of(std::back_insert_iterator<std::string>& it) {
+        return *(it.*(&StringInserterAccess::container));
+    }
+};
+
+/**
+ * @brief Appends a run of bytes to the target string with a single append
+ */
+inline std::back_insert_iterator<std::string> copy_bytes(const char* first, const char* last, std::back_insert_iterator<std::string> result) {
+    StringInserterAccess::container_of(result).append(first, last);
     return result;
 }
 
+/**
+ * @brief Copies a run of bytes to a raw buffer with memcpy
+ */
+inline char* copy_bytes(const char* first, const char* last, char* result) {
+    std::size_t count = static_cast<std::size_t>(last - first);
+    if (count > 0) {
+        std::memcpy(result, first, count);
+    }
+    return result + count;
+}
+
+/**
+ * @brief Copies input bytes [start, end) to an output iterator
+ */
+template<typename OutputIt>
+inline OutputIt copy_byte_range(const std::string& input, std::size_t start, std::size_t end, OutputIt result) {
+    return copy_bytes(input.data() + start, input.data() + end, result);
+}
+
+} // namespace details
+
+/**
+ * @brief STL-like copy function - copies all characters
+ *
+ * Characters are contiguous in the input, so the whole string after the BOM is copied as one run.
+ */
+template<typename OutputIt>
+inline OutputIt copy(const std::string& input, OutputIt result) {
+    std::size_t start = details::detect_bom(input).found ? 3 : 0;
+    return details::copy_byte_range(input, start, input.length(), result);
+}
+
 /**
  * @brief STL-like copy_if - copies characters matching a predicate
+ *
+ * Consecutive matching characters are written as one run.
  */
 template<typename OutputIt, typename Predicate>
 inline OutputIt copy_if(const std::string& input, OutputIt result, Predicate pred) {
     auto range = make_char_range(input);
+    std::size_t run_start = range.begin().position();
+    std::size_t run_end = run_start;
     for (const auto& char_info : range) {
         if (pred(char_info)) {
-            std::string char_str = input.substr(char_info.start_pos, char_info.byte_count);
-            result = std::copy(char_str.begin(), char_str.end(), result);
+            if (char_info.start_pos != run_end) {
+                result = details::copy_byte_range(input, run_start, run_end, result);
+                run_start = char_info.start_pos;
+            }
+            run_end = char_info.start_pos + char_info.byte_count;
         }
     }
-    return result;
+    return details::copy_byte_range(input, run_start, run_end, result);
 }
 
 /**
@@ -623,14 +1623,8 @@ inline OutputIt copy_if(const std::string& input, OutputIt result, Predicate pre
 template<typename OutputIt, typename Predicate>
 inline OutputIt copy_until(const std::string& input, OutputIt result, Predicate pred) {
     auto range = make_char_range(input);
-    for (const auto& char_info : range) {
-        if (pred(char_info)) {
-            break;
-        }
-        std::string char_str = input.substr(char_info.start_pos, char_info.byte_count);
-        result = std::copy(char_str.begin(), char_str.end(), result);
-    }
-    return result;
+    auto stop_it = std::find_if(range.begin(), range.end(), pred);
+    return details::copy_byte_range(input, range.begin().position(), stop_it.position(), result);
 }
 
 /**
@@ -640,11 +1634,7 @@ template<typename OutputIt, typename Predicate>
 inline OutputIt copy_from(const std::string& input, OutputIt result, Predicate pred) {
     auto range = make_char_range(input);
     auto start_it = std::find_if(range.begin(), range.end(), pred);
-    for (auto it = start_it; it != range.end(); ++it) {
-        std::string char_str = input.substr(it->start_pos, it->byte_count);
-        result = std::copy(char_str.begin(), char_str.end(), result);
-    }
-    return result;
+    return details::copy_byte_range(input, start_it.position(), input.length(), result);
 }
 
 /**
@@ -654,11 +1644,10 @@ template<typename OutputIt>
 inline OutputIt copy_n(const std::string& input, OutputIt result, size_t n) {
     auto range = make_char_range(input);
     auto it = range.begin();
-    for (size_t i = 0; i < n && it != range.end(); ++i, ++it) {
-        std::string char_str = input.substr(it->start_pos, it->byte_count);
-        result = std::copy(char_str.begin(), char_str.end(), result);
+    for (; n > 0 && it != range.end(); --n) {
+        ++it;
     }
-    return result;
+    return details::copy_byte_range(input, range.begin().position(), it.position(), result);
 }
 
 /**
@@ -667,14 +1656,202 @@ inline OutputIt copy_n(const std::string& input, OutputIt result, size_t n) {
 template<typename OutputIt, typename Predicate>
 inline OutputIt copy_while(const std::string& input, OutputIt result, Predicate pred) {
     auto range = make_char_range(input);
-    for (const auto& char_info : range) {
-        if (!pred(char_info)) {
-            break;
+    auto stop_it = std::find_if_not(range.begin(), range.end(), pred);
+    return details::copy_byte_range(input, range.begin().position(), stop_it.position(), result);
+}
+
+namespace details {
+
+/**
+ * @brief Character state passed through the stages of a pipeline
+ */
+struct PipelineChar {
+    CharInfo info;                      ///< Character, with the codepoint updated by map stages
+    const std::string* replacement;     ///< Set by a replace stage, bypasses later stages
+    bool modified;                      ///< True if a map stage changed the codepoint
+};
+
+/**
+ * @brief First stage of every pipeline, passes all characters
+ */
+struct PipelineSource {
+    bool process(PipelineChar& /*c*/) { return true; }
+};
+
+template<typename Prev, typename Predicate>
+struct PipelineFilter {
+    Prev prev;
+    Predicate pred;
+
+    PipelineFilter(const Prev& p, Predicate f) : prev(p), pred(f) {}
+
+    bool process(PipelineChar& c) {
+        if (!prev.process(c)) return false;
+        return c.replacement != nullptr || pred(c.info);
+    }
+};
+
+template<typename Prev, typename Mapper>
+struct PipelineMap {
+    Prev prev;
+    Mapper mapper;
+
+    PipelineMap(const Prev& p, Mapper m) : prev(p), mapper(m) {}
+
+    bool process(PipelineChar& c) {
+        if (!prev.process(c)) return false;
+        if (c.replacement == nullptr) {
+            uint32_t cp = static_cast<uint32_t>(mapper(c.info));
+            if (cp != c.info.codepoint) {
+                c.info.codepoint = cp;
+                c.info.is_ascii = cp < 0x80;
+                c.modified = true;
+            }
         }
-        std::string char_str = input.substr(char_info.start_pos, char_info.byte_count);
-        result = std::copy(char_str.begin(), char_str.end(), result);
+        return true;
     }
-    return result;
+};
+
+template<typename Prev, typename Predicate>
+struct PipelineReplace {
+    Prev prev;
+    Predicate pred;
+    std::string text;
+
+    PipelineReplace(const Prev& p, Predicate f, const std::string& t) : prev(p), pred(f), text(t) {}
+
+    bool process(PipelineChar& c) {
+        if (!prev.process(c)) return false;
+        if (c.replacement == nullptr && pred(c.info)) {
+            c.replacement = &text;
+        }
+        return true;
+    }
+};
+
+struct StringSink {
+    std::string& output;
+    void append(const char* data, std::size_t count) { output.append(data, count); }
+};
+
+template<typename OutputIt>
+struct IteratorSink {
+    OutputIt output;
+    void append(const char* data, std::size_t count) { output = copy_bytes(data, data + count, output); }
+};
+
+/**
+ * @brief Single decoding pass over the input, unchanged characters are written in runs
+ */
+template<typename Chain, typename Sink>
+inline void run_pipeline(Chain& chain, const std::string& input, Sink& sink) {
+    std::size_t pos = detect_bom(input).found ? 3 : 0;
+    std::size_t run_start = pos;
+
+    while (pos < input.length()) {
+        PipelineChar c;
+        c.info = extract_char_info(input, pos, true, true);
+        c.replacement = nullptr;
+        c.modified = false;
+        std::size_t byte_count = c.info.byte_count;
+
+        bool keep = chain.process(c);
+        if (keep && !c.modified && c.replacement == nullptr) {
+            pos += byte_count;  // Extend the current run of unchanged characters
+            continue;
+        }
+
+        sink.append(input.data() + run_start, pos - run_start);
+        if (keep) {
+            if (c.replacement != nullptr) {
+                sink.append(c.replacement->data(), c.replacement->length());
+            } else {
+                char buffer[4];
+                sink.append(buffer, encode_utf8(c.info.codepoint, buffer));
+            }
+        }
+        pos += byte_count;
+        run_start = pos;
+    }
+    sink.append(input.data() + run_start, pos - run_start);
+}
+
+} // namespace details
+
+/**
+ * @brief Fused character processing pipeline built from filter, map and replace stages
+ *
+ * Stages are composed at compile time into a single type, so running the pipeline decodes
+ * the input once and calls every stage inline for each character, without intermediate strings.
+ * - `filter(pred)` drops characters for which `pred(const CharInfo&)` is false
+ * - `map(fn)` replaces the codepoint with `fn(const CharInfo&)` (e.g. `to_lower_ascii`)
+ * - `replace(pred, text)` outputs `text` instead of matching characters; replaced characters
+ *   bypass all later stages
+ *
+ * @code
+ * auto normalize = u8scan::pipeline()
+ *     .filter(u8scan::predicates::is_valid())
+ *     .map([](const u8scan::CharInfo& info) { return u8scan::to_lower_ascii(info); })
+ *     .replace(u8scan::predicates::is_whitespace_ascii(), "_");
+ * std::string key = normalize("Hello World");   // "hello_world"
+ * @endcode
+ */
+template<typename Chain>
+class Pipeline {
+private:
+    Chain chain_;
+
+public:
+    explicit Pipeline(const Chain& chain) : chain_(chain) {}
+
+    template<typename Predicate>
+    Pipeline<details::PipelineFilter<Chain, Predicate>> filter(Predicate pred) const {
+        return Pipeline<details::PipelineFilter<Chain, Predicate>>(details::PipelineFilter<Chain, Predicate>(chain_, pred));
+    }
+
+    template<typename Mapper>
+    Pipeline<details::PipelineMap<Chain, Mapper>> map(Mapper mapper) const {
+        return Pipeline<details::PipelineMap<Chain, Mapper>>(details::PipelineMap<Chain, Mapper>(chain_, mapper));
+    }
+
+    template<typename Predicate>
+    Pipeline<details::PipelineReplace<Chain, Predicate>> replace(Predicate pred, const std::string& text) const {
+        return Pipeline<details::PipelineReplace<Chain, Predicate>>(details::PipelineReplace<Chain, Predicate>(chain_, pred, text));
+    }
+
+    /**
+     * @brief Run the pipeline writing bytes to an output iterator
+     */
+    template<typename OutputIt>
+    OutputIt run(const std::string& input, OutputIt result) const {
+        Chain chain(chain_);
+        details::IteratorSink<OutputIt> sink = { result };
+        details::run_pipeline(chain, input, sink);
+        return sink.output;
+    }
+
+    /**
+     * @brief Run the pipeline and return the output string
+     */
+    std::string run(const std::string& input) const {
+        std::string result;
+        result.reserve(input.length());
+        Chain chain(chain_);
+        details::StringSink sink = { result };
+        details::run_pipeline(chain, input, sink);
+        return result;
+    }
+
+    std::string operator()(const std::string& input) const {
+        return run(input);
+    }
+};
+
+/**
+ * @brief Start building a fused processing pipeline
+ */
+inline Pipeline<details::PipelineSource> pipeline() {
+    return Pipeline<details::PipelineSource>(details::PipelineSource());
 }
 
 /**
@@ -852,44 +2029,730 @@ inline CharInfo back(const std::string& input, bool utf8_mode = true, bool valid
 }
 
 /**
- * @brief The `predicates` namespace provides a collection of predicate functions
- * suitable for use with STL algorithms.
+ * @brief Byte length of the prefix holding the first n characters of a UTF-8 string
+ * @param input The UTF-8 string
+ * @param n Number of characters (code points)
+ * @return Number of bytes to keep, including a leading BOM; input.length() if the string has at most n characters
+ *
+ * Character boundaries are found by counting lead bytes (every byte except 10xxxxxx) 32 bytes
+ * at a time, without decoding. The result matches copy_n() for valid UTF-8; in malformed input
+ * stray continuation bytes stay with the preceding character, so the prefix never ends inside
+ * a multi-byte sequence.
+ *
+ * @code
+ * std::string name = u8"Zoë Łukasiewicz 🌍";
+ * std::string field = name.substr(0, u8scan::prefix_bytes(name, 3));  // "Zoë"
+ * @endcode
  */
-namespace predicates {
+inline std::size_t prefix_bytes(const std::string& input, std::size_t n) {
+    std::size_t start_pos = details::detect_bom(input).found ? 3 : 0;
+    if (n == 0) {
+        return start_pos;   // Stray continuation bytes at the start belong to the first character
+    }
+    if (n >= input.length() - start_pos) {
+        return input.length();
+    }
+    return details::find_nth_lead_byte(input.data(), start_pos, input.length(), n + 1);
+}
 
 /**
- * @brief Check if character is ASCII
- * @return Predicate function that returns true for ASCII characters (codepoint < 0x80)
+ * @brief Byte length of the suffix holding the last n characters of a UTF-8 string
+ * @param input The UTF-8 string
+ * @param n Number of characters (code points)
+ * @return Number of bytes at the end of the input; a leading BOM is never part of the suffix
+ *
+ * Uses the same lead byte counting as prefix_bytes(), scanning backwards from the end.
+ *
+ * @code
+ * std::string text = u8"Hello 世界";
+ * std::string tail = text.substr(text.length() - u8scan::suffix_bytes(text, 2));  // "世界"
+ * @endcode
  */
-inline std::function<bool(const CharInfo&)> is_ascii() {
-    return [](const CharInfo& info) { return info.is_ascii; };
+inline std::size_t suffix_bytes(const std::string& input, std::size_t n) {
+    std::size_t start_pos = details::detect_bom(input).found ? 3 : 0;
+    if (n == 0) {
+        return 0;
+    }
+    return input.length() - details::rfind_nth_lead_byte(input.data(), start_pos, input.length(), n);
 }
 
+namespace details {
+
 /**
- * @brief Check if character is UTF-8 multi-byte
- * @return Predicate function that returns true for UTF-8 multi-byte characters (codepoint >= 0x80)
+ * @brief Position of the first byte outside printable ASCII (0x20 to 0x7E) in data[pos, length)
  */
-inline std::function<bool(const CharInfo&)> is_utf8() {
-    return [](const CharInfo& info) { return !info.is_ascii; };
+inline std::size_t skip_printable_ascii(const char* data, std::size_t pos, std::size_t length) {
+#if defined(U8SCAN_HAS_SSE2)
+    const __m128i below = _mm_set1_epi8(0x1F);
+    const __m128i above = _mm_set1_epi8(0x7F);
+    for (; pos + 16 <= length; pos += 16) {
+        // Signed comparisons, bytes from 0x80 are negative
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, below), _mm_cmplt_epi8(v, above));
+        uint32_t mask = static_cast<uint32_t>(~_mm_movemask_epi8(printable)) & 0xFFFFu;
+        if (mask != 0) {
+            return pos + lowest_bit_index(mask);
+        }
+    }
+#endif
+    while (pos < length && static_cast<unsigned char>(data[pos]) >= 0x20 && static_cast<unsigned char>(data[pos]) < 0x7F) {
+        ++pos;
+    }
+    return pos;
 }
 
 /**
- * @brief Check if character is valid UTF-8
- * @return Predicate function that returns true for valid UTF-8 sequences
+ * @brief End of the longest prefix of input[pos, end) that is at most max_width columns wide
+ * @param width Set to the width of the prefix
+ *
+ * Zero-width characters right after the prefix are included, so combining marks stay with
+ * their base character.
  */
-inline std::function<bool(const CharInfo&)> is_valid() {
-    return [](const CharInfo& info) { return info.is_valid_utf8; };
+inline std::size_t width_prefix(const std::string& input, std::size_t pos, std::size_t max_width, std::size_t& width) {
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t last_pos = pos;     // Start and column_width() of the last character
+    uint8_t last = 0;
+    width = 0;
+    while (pos < length) {
+        std::size_t run_end = skip_printable_ascii(data, pos, length);
+        if (run_end != pos) {
+            // Printable ASCII is one column per byte
+            if (run_end - pos > max_width - width) {
+                pos += max_width - width;
+                width = max_width;
+                return pos;
+            }
+            width += run_end - pos;
+            last_pos = run_end - 1;
+            last = ucd::column_width(static_cast<unsigned char>(data[last_pos]));
+            pos = run_end;
+            continue;
+        }
+
+        CharInfo info = extract_char_info(input, pos, true, true);
+        uint8_t columns = info.is_valid_utf8 ? ucd::column_width(info.codepoint) : 1;
+        std::size_t char_width = columns & 0x03u;
+        if (info.codepoint == 0xFE0F && (last & ucd::width_emoji_text_presentation) != 0) {
+            // The emoji presentation selector makes the preceding emoji wide
+            if (width == max_width) {
+                width -= 1;
+                return last_pos;
+            }
+            char_width = 1;
+        }
+        if (char_width > max_width - width) {
+            return pos;
+        }
+        width += char_width;
+        last_pos = pos;
+        last = columns;
+        pos += info.byte_count;
+    }
+    return pos;
 }
 
+} // namespace details
+
+/**
+ * @brief Number of terminal columns needed to display a UTF-8 string
+ * @param input The UTF-8 string
+ * @return Sum of the character widths; a leading BOM is skipped
+ *
+ * Wide and fullwidth characters (East_Asian_Width W or F: CJK ideographs, Hangul syllables, most
+ * emoji) take 2 columns. Combining marks, format characters such as ZWJ, conjoining Hangul
+ * vowels and final consonants, and control characters (including tab and newline) take none.
+ * Everything else, including ambiguous-width characters and each invalid byte, takes 1 column. A
+ * text-style emoji followed by U+FE0F takes 2 columns. Emoji sequences are counted per code
+ * point, like wcswidth().
+ *
+ * Runs of printable ASCII are counted 16 bytes at a time without decoding; the width table is
+ * only consulted for other characters.
+ *
+ * @code
+ * u8scan::display_width(u8"Hello");              // 5
+ * u8scan::display_width(u8"世界!");               // 5
+ * u8scan::display_width(u8"e\u0301");            // 1, e with a combining acute accent
+ * u8scan::display_width(u8"\u2764\uFE0F");       // 2, red heart with emoji presentation
+ * @endcode
+ */
+inline std::size_t display_width(const std::string& input) {
+    std::size_t width;
+    details::width_prefix(input, details::detect_bom(input).found ? 3 : 0, std::string::npos, width);
+    return width;
+}
+
+/**
+ * @brief Longest prefix of a UTF-8 string that fits in a number of terminal columns
+ * @param input The UTF-8 string
+ * @param cols Maximum width in columns, see display_width()
+ * @return The prefix, including a leading BOM; never ends inside a character
+ *
+ * Zero-width characters following the last character that fits are kept with it. A wide
+ * character that does not fit is left out entirely, so the result may be one column narrower
+ * than cols.
+ *
+ * @code
+ * u8scan::truncate_to_width(u8"日本語テキスト", 5);  // "日本"
+ * u8scan::truncate_to_width(u8"café au lait", 4);   // "café"
+ * @endcode
+ */
+inline std::string truncate_to_width(const std::string& input, std::size_t cols) {
+    std::size_t width;
+    return input.substr(0, details::width_prefix(input, details::detect_bom(input).found ? 3 : 0, cols, width));
+}
+
+/**
+ * @brief Number of emoji characters in a UTF-8 string
+ * @param input The UTF-8 string
+ * @return Number of characters matching predicates::is_emoji()
+ *
+ * Runs of ASCII are skipped 16 bytes at a time, and since every emoji is above U+0800 only
+ * sequences of 3 or 4 bytes are decoded and looked up. Sequences are decoded as by
+ * make_char_range(), so the result equals counting with predicates::is_emoji() over a character
+ * range, also for ill-formed input.
+ *
+ * @code
+ * u8scan::count_emoji(u8"Hello 🌍 World 123 🚀!");     // 2
+ * u8scan::count_emoji(u8"\U0001F1FA\U0001F1F8");       // 2, the regional indicators of a flag
+ * @endcode
+ */
+inline std::size_t count_emoji(const std::string& input) {
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t count = 0;
+    std::size_t pos = 0;
+    while ((pos = details::skip_ascii(data, pos, length)) < length) {
+        std::size_t bytes = details::decoded_sequence_length(data, pos, length);
+        if (bytes >= 3 && details::ucd::is_emoji(details::decode_utf8(data + pos, bytes))) {
+            ++count;
+        }
+        pos += bytes;
+    }
+    return count;
+}
+
+namespace details {
+
+/**
+ * @brief Minimum chunk size (in bytes) used when the chunk count is chosen automatically
+ */
+inline std::size_t parallel_min_chunk_size() {
+    return 64 * 1024;
+}
+
+/**
+ * @brief Move a split position forward to the next codepoint boundary
+ *
+ * A validating decoder never consumes a non-continuation byte as part of another character,
+ * and never lets a sequence cover more than 3 continuation bytes, so the first position that is
+ * either a non-continuation byte or preceded by 3 continuation bytes is a character boundary.
+ */
+inline std::size_t align_to_char_boundary(const std::string& input, std::size_t pos, std::size_t end_pos) {
+    for (int steps = 0; steps < 3 && pos < end_pos; ++steps, ++pos) {
+        if ((static_cast<unsigned char>(input[pos]) & 0xC0) != 0x80) {
+            break;
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief Move a split position forward to a position every non-validating decode passes through
+ *
+ * Without validation a lead byte consumes the bytes it declares whatever they are, so a chunk
+ * must not end within the declared length of any of the 3 bytes before its end; otherwise its
+ * last character would step over the chunk end.
+ */
+inline std::size_t align_to_unvalidated_boundary(const std::string& input, std::size_t pos, std::size_t end_pos) {
+    for (; pos < end_pos; ++pos) {
+        bool crossed = false;
+        for (std::size_t back = 1; back <= 3 && back <= pos && !crossed; ++back) {
+            unsigned char byte = static_cast<unsigned char>(input[pos - back]);
+            std::size_t declared = (byte & 0xE0) == 0xC0 ? 2 : (byte & 0xF0) == 0xE0 ? 3 : (byte & 0xF8) == 0xF0 ? 4 : 1;
+            crossed = declared > back && pos - back + declared <= input.length();
+        }
+        if (!crossed) {
+            break;
+        }
+    }
+    return pos;
+}
+
+} // namespace details
+
+/**
+ * @brief Character range split into chunks that start on codepoint boundaries
+ *
+ * Each chunk is exposed as a regular `CharRange`, so chunks can be processed independently
+ * on separate threads (std::thread) and the per-thread results reduced at the end.
+ * Chunk boundaries follow the validating decoder. With validation disabled, boundaries are
+ * moved past any lead byte whose declared sequence would cross them, so each chunk ends exactly
+ * at its bound; malformed input may still be split differently than a sequential scan would
+ * decode it.
+ *
+ * @code
+ * auto range = u8scan::make_parallel_char_range(corpus);   // one chunk per hardware thread
+ * std::size_t chars = range.length();
+ * std::size_t emoji = range.count_if(u8scan::predicates::is_emoji());
+ * bool valid = range.validate();
+ * @endcode
+ */
+class ParallelCharRange {
+private:
+    const std::string* str_;
+    std::vector<std::size_t> bounds_;   ///< Chunk boundaries (chunk_count() + 1 entries)
+    bool utf8_mode_;
+    bool validate_;
+
+public:
+    /**
+     * @param str The string to split
+     * @param chunk_count Number of chunks; 0 selects one chunk per hardware thread,
+     *                    limited so that chunks are not smaller than 64 KB
+     */
+    ParallelCharRange(const std::string& str, std::size_t chunk_count = 0, bool utf8_mode = true, bool validate = true, bool skip_bom = true)
+        : str_(&str), utf8_mode_(utf8_mode), validate_(validate) {
+        std::size_t start_pos = (skip_bom && details::detect_bom(str).found) ? 3 : 0;
+        std::size_t byte_count = str.length() - start_pos;
+
+        if (chunk_count == 0) {
+            chunk_count = static_cast<std::size_t>(std::thread::hardware_concurrency());
+            chunk_count = std::min(chunk_count, byte_count / details::parallel_min_chunk_size());
+        }
+        chunk_count = std::max<std::size_t>(1, std::min(chunk_count, byte_count));
+
+        bounds_.reserve(chunk_count + 1);
+        bounds_.push_back(start_pos);
+        for (std::size_t i = 1; i < chunk_count; ++i) {
+            std::size_t pos = start_pos + byte_count / chunk_count * i;
+            if (utf8_mode_) {
+                pos = validate_ ? details::align_to_char_boundary(str, pos, str.length())
+                                : details::align_to_unvalidated_boundary(str, pos, str.length());
+            }
+            bounds_.push_back(std::max(pos, bounds_.back()));
+        }
+        bounds_.push_back(str.length());
+    }
+
+    std::size_t chunk_count() const { return bounds_.size() - 1; }
+
+    /**
+     * @brief Get the character range of a single chunk
+     */
+    CharRange chunk(std::size_t index) const {
+        return CharRange(*str_, bounds_[index], bounds_[index + 1], utf8_mode_, validate_, false);
+    }
+
+    CharIterator begin() const {
+        return CharIterator(str_, bounds_.front(), utf8_mode_, validate_);
+    }
+
+    CharIterator end() const {
+        return CharIterator(str_, bounds_.back(), utf8_mode_, validate_);
+    }
+
+    /**
+     * @brief Apply a function to every chunk on its own thread and combine the results
+     * @param init Initial value of the reduction
+     * @param chunk_fn Function `T(const CharRange&)` called once per chunk
+     * @param combine Function `T(const T&, const T&)` combining partial results in chunk order
+     *
+     * The first chunk is processed on the calling thread. Exceptions thrown by `chunk_fn`
+     * are rethrown on the calling thread after all workers have finished.
+     */
+    template<typename T, typename ChunkFunction, typename Combine>
+    T reduce(T init, ChunkFunction chunk_fn, Combine combine) const {
+        std::size_t count = chunk_count();
+        std::vector<T> partial(count, init);
+        std::vector<std::exception_ptr> errors(count);
+
+        auto task = [&](std::size_t index) {
+            try {
+                partial[index] = chunk_fn(chunk(index));
+            } catch (...) {
+                errors[index] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(count);
+        for (std::size_t i = 1; i < count; ++i) {
+            try {
+                workers.emplace_back(task, i);
+            } catch (const std::system_error&) {
+                task(i);  // Thread could not be started, process chunk inline
+            }
+        }
+        task(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        T result = init;
+        for (const auto& value : partial) {
+            result = combine(result, value);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Count characters in all chunks, same result as `u8scan::length()`
+     */
+    std::size_t length() const {
+        return reduce(std::size_t(0),
+            [](const CharRange& range) { return range.size(); },
+            [](std::size_t a, std::size_t b) { return a + b; });
+    }
+
+    /**
+     * @brief Count characters matching a predicate (e.g. one from `u8scan::predicates`)
+     */
+    template<typename Predicate>
+    std::size_t count_if(Predicate pred) const {
+        return reduce(std::size_t(0),
+            [&pred](const CharRange& range) {
+                return static_cast<std::size_t>(std::count_if(range.begin(), range.end(), pred));
+            },
+            [](std::size_t a, std::size_t b) { return a + b; });
+    }
+
+    /**
+     * @brief Check that all characters are valid UTF-8 sequences
+     */
+    bool validate() const {
+        std::size_t invalid_chunks = reduce(std::size_t(0),
+            [](const CharRange& range) {
+                return std::all_of(range.begin(), range.end(),
+                    [](const CharInfo& info) { return info.is_valid_utf8; }) ? std::size_t(0) : std::size_t(1);
+            },
+            [](std::size_t a, std::size_t b) { return a + b; });
+        return invalid_chunks == 0;
+    }
+};
+
+/**
+ * @brief Create a character range split into chunks for parallel processing
+ * @param chunk_count Number of chunks; 0 selects one chunk per hardware thread (for large inputs)
+ */
+inline ParallelCharRange make_parallel_char_range(const std::string& str, std::size_t chunk_count = 0, bool utf8_mode = true, bool validate = true, bool skip_bom = true) {
+    return ParallelCharRange(str, chunk_count, utf8_mode, validate, skip_bom);
+}
+
+/**
+ * @brief Outputs of `scan_batch()` stored in one contiguous arena
+ *
+ * Output `i` occupies bytes `[offsets[i], offsets[i + 1])` of `data`.
+ */
+struct BatchOutput {
+    std::string data;                   ///< All outputs, concatenated in input order
+    std::vector<std::size_t> offsets;   ///< Start offsets of outputs (size() + 1 entries)
+
+    std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    const char* data_at(std::size_t index) const { return data.data() + offsets[index]; }
+    std::size_t length(std::size_t index) const { return offsets[index + 1] - offsets[index]; }
+    std::string str(std::size_t index) const { return data.substr(offsets[index], length(index)); }
+};
+
+namespace details {
+
+/**
+ * @brief Number of inputs claimed at once by a `scan_batch()` worker
+ */
+inline std::size_t batch_block_size(std::size_t input_count, std::size_t thread_count) {
+    // Several blocks per worker so that idle workers have something to steal
+    std::size_t block_size = input_count / (thread_count * 8);
+    return std::max<std::size_t>(1, std::min<std::size_t>(block_size, 256));
+}
+
+} // namespace details
+
+/**
+ * @brief Scan many strings with `scan_utf8()` semantics on a pool of worker threads
+ * @param inputs Strings to scan
+ * @param processor Character processor, copied once per worker thread
+ * @param outputs Receives all outputs in one arena with an offsets array
+ * @param thread_count Number of worker threads; 0 selects one per hardware thread
+ *
+ * Inputs are grouped into blocks that are distributed evenly between per-worker queues;
+ * a worker that runs out of blocks steals the remaining ones from other queues. Each block
+ * is scanned into a single reused buffer, and block buffers are merged in input order.
+ *
+ * @code
+ * u8scan::BatchOutput out;
+ * u8scan::scan_batch(rows, [](const u8scan::CharInfo& info, const char*) {
+ *     return info.is_ascii ? u8scan::ProcessResult() : u8scan::ProcessResult(u8scan::ScanAction::IGNORE);
+ * }, out);
+ * std::string first = out.str(0);
+ * @endcode
+ */
+template<typename Processor>
+inline void scan_batch(const std::vector<std::string>& inputs, Processor processor, BatchOutput& outputs, std::size_t thread_count = 0) {
+    struct Block {
+        std::string data;
+        std::vector<std::size_t> ends;
+    };
+
+    std::size_t input_count = inputs.size();
+    if (thread_count == 0) {
+        thread_count = std::max<std::size_t>(1, static_cast<std::size_t>(std::thread::hardware_concurrency()));
+    }
+    std::size_t block_size = details::batch_block_size(input_count, thread_count);
+    std::size_t block_count = (input_count + block_size - 1) / block_size;
+    thread_count = std::max<std::size_t>(1, std::min(thread_count, block_count));
+
+    std::vector<Block> blocks(block_count);
+    std::vector<std::atomic<std::size_t>> next_block(thread_count);
+    std::vector<std::size_t> end_block(thread_count);
+    for (std::size_t w = 0; w < thread_count; ++w) {
+        next_block[w].store(block_count * w / thread_count);
+        end_block[w] = block_count * (w + 1) / thread_count;
+    }
+    std::vector<std::exception_ptr> errors(thread_count);
+
+    auto process_block = [&](Processor& local_processor, std::size_t block_index) {
+        Block& block = blocks[block_index];
+        std::size_t first = block_index * block_size;
+        std::size_t last = std::min(input_count, first + block_size);
+        std::size_t input_bytes = 0;
+        for (std::size_t i = first; i < last; ++i) {
+            input_bytes += inputs[i].length();
+        }
+        block.data.reserve(input_bytes);
+        block.ends.reserve(last - first);
+        for (std::size_t i = first; i < last; ++i) {
+            details::scan_utf8_append(inputs[i], local_processor, block.data);
+            block.ends.push_back(block.data.length());
+        }
+    };
+
+    auto worker = [&](std::size_t worker_index) {
+        try {
+            Processor local_processor(processor);
+            // Drain own queue first, then steal from the other queues
+            for (std::size_t k = 0; k < thread_count; ++k) {
+                std::size_t queue = (worker_index + k) % thread_count;
+                for (;;) {
+                    std::size_t block_index = next_block[queue].fetch_add(1);
+                    if (block_index >= end_block[queue]) break;
+                    process_block(local_processor, block_index);
+                }
+            }
+        } catch (...) {
+            errors[worker_index] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    for (std::size_t w = 1; w < thread_count; ++w) {
+        try {
+            workers.emplace_back(worker, w);
+        } catch (const std::system_error&) {
+            break;  // Remaining queues are stolen by the running workers
+        }
+    }
+    worker(0);
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Merge block buffers into the output arena
+    std::size_t total_bytes = 0;
+    for (const auto& block : blocks) {
+        total_bytes += block.data.length();
+    }
+    outputs.data.clear();
+    outputs.data.reserve(total_bytes);
+    outputs.offsets.clear();
+    outputs.offsets.reserve(input_count + 1);
+    outputs.offsets.push_back(0);
+    for (const auto& block : blocks) {
+        std::size_t base = outputs.data.length();
+        outputs.data += block.data;
+        for (std::size_t end : block.ends) {
+            outputs.offsets.push_back(base + end);
+        }
+    }
+}
+
+/**
+ * @brief Unicode General_Category values, see general_category()
+ */
+enum class GeneralCategory : uint8_t {
+    Cn,     ///< Unassigned
+    Lu,     ///< Uppercase letter
+    Ll,     ///< Lowercase letter
+    Lt,     ///< Titlecase letter
+    Lm,     ///< Modifier letter
+    Lo,     ///< Other letter
+    Mn,     ///< Nonspacing mark
+    Mc,     ///< Spacing mark
+    Me,     ///< Enclosing mark
+    Nd,     ///< Decimal number
+    Nl,     ///< Letter number
+    No,     ///< Other number
+    Pc,     ///< Connector punctuation
+    Pd,     ///< Dash punctuation
+    Ps,     ///< Open punctuation
+    Pe,     ///< Close punctuation
+    Pi,     ///< Initial quote punctuation
+    Pf,     ///< Final quote punctuation
+    Po,     ///< Other punctuation
+    Sm,     ///< Math symbol
+    Sc,     ///< Currency symbol
+    Sk,     ///< Modifier symbol
+    So,     ///< Other symbol
+    Zs,     ///< Space separator
+    Zl,     ///< Line separator
+    Zp,     ///< Paragraph separator
+    Cc,     ///< Control
+    Cf,     ///< Format
+    Cs,     ///< Surrogate
+    Co      ///< Private use
+};
+
+/**
+ * @brief General_Category of a code point
+ *
+ * One lookup in the generated two-stage table of u8scan_tables.h.
+ *
+ * @code
+ * u8scan::general_category(0x00E9);   // GeneralCategory::Ll
+ * u8scan::general_category(0x4E16);   // GeneralCategory::Lo
+ * @endcode
+ */
+inline GeneralCategory general_category(uint32_t cp) {
+    static_assert(details::ucd::category_co == static_cast<uint8_t>(GeneralCategory::Co), "GeneralCategory follows the table values");
+    return static_cast<GeneralCategory>(details::ucd::general_category(cp));
+}
+
+namespace details {
+
+/**
+ * @brief Bit of the General_Category of a character, to test against the masks below; 0 for invalid bytes
+ */
+inline uint32_t category_bit(const CharInfo& info) {
+    return info.is_valid_utf8 ? 1u << ucd::general_category(info.codepoint) : 0u;
+}
+
+constexpr uint32_t letter_categories = (1u << ucd::category_lu) | (1u << ucd::category_ll) | (1u << ucd::category_lt) |
+                                       (1u << ucd::category_lm) | (1u << ucd::category_lo);
+constexpr uint32_t mark_categories = (1u << ucd::category_mn) | (1u << ucd::category_mc) | (1u << ucd::category_me);
+constexpr uint32_t number_categories = (1u << ucd::category_nd) | (1u << ucd::category_nl) | (1u << ucd::category_no);
+constexpr uint32_t punctuation_categories = (1u << ucd::category_pc) | (1u << ucd::category_pd) | (1u << ucd::category_ps) |
+                                            (1u << ucd::category_pe) | (1u << ucd::category_pi) | (1u << ucd::category_pf) |
+                                            (1u << ucd::category_po);
+constexpr uint32_t symbol_categories = (1u << ucd::category_sm) | (1u << ucd::category_sc) | (1u << ucd::category_sk) |
+                                       (1u << ucd::category_so);
+constexpr uint32_t separator_categories = (1u << ucd::category_zs) | (1u << ucd::category_zl) | (1u << ucd::category_zp);
+
+} // namespace details
+
+/**
+ * @brief Character predicates for STL algorithms and the copy and scan functions
+ *
+ * Each predicate comes in two forms: a factory returning `std::function`, e.g. `is_ascii()`, and
+ * a functor type with a `_t` suffix, e.g. `is_ascii_t`. Both can be passed wherever a predicate
+ * is expected. The functors are called directly and can be inlined by `std::count_if` and the
+ * other algorithms, while the `std::function` forms make an indirect call per character.
+ *
+ * @code
+ * auto range = u8scan::make_char_range(input);
+ * auto ascii = std::count_if(range.begin(), range.end(), u8scan::predicates::is_ascii_t());
+ * @endcode
+ */
+namespace predicates {
+
+/// Functor form of is_ascii()
+struct is_ascii_t {
+    bool operator()(const CharInfo& info) const {
+        return info.is_ascii;
+    }
+};
+
+/**
+ * @brief Check if character is ASCII
+ * @return Predicate function that returns true for ASCII characters (codepoint < 0x80)
+ */
+inline std::function<bool(const CharInfo&)> is_ascii() {
+    return is_ascii_t();
+}
+
+/// Functor form of is_utf8()
+struct is_utf8_t {
+    bool operator()(const CharInfo& info) const {
+        return !info.is_ascii;
+    }
+};
+
+/**
+ * @brief Check if character is UTF-8 multi-byte
+ * @return Predicate function that returns true for UTF-8 multi-byte characters (codepoint >= 0x80)
+ */
+inline std::function<bool(const CharInfo&)> is_utf8() {
+    return is_utf8_t();
+}
+
+/// Functor form of is_valid()
+struct is_valid_t {
+    bool operator()(const CharInfo& info) const {
+        return info.is_valid_utf8;
+    }
+};
+
+/**
+ * @brief Check if character is valid UTF-8
+ * @return Predicate function that returns true for valid UTF-8 sequences
+ */
+inline std::function<bool(const CharInfo&)> is_valid() {
+    return is_valid_t();
+}
+
+/// Functor form of has_codepoint()
+struct has_codepoint_t {
+    uint32_t codepoint;
+
+    explicit has_codepoint_t(uint32_t cp) : codepoint(cp) {}
+
+    bool operator()(const CharInfo& info) const {
+        return info.codepoint == codepoint;
+    }
+};
+
 /**
  * @brief Check if character has specific codepoint
  * @param codepoint The Unicode codepoint to match
  * @return Predicate function that returns true if character matches the codepoint
  */
 inline std::function<bool(const CharInfo&)> has_codepoint(uint32_t codepoint) {
-    return [codepoint](const CharInfo& info) { return info.codepoint == codepoint; };
+    return has_codepoint_t(codepoint);
 }
 
+/// Functor form of in_range()
+struct in_range_t {
+    uint32_t min_cp;
+    uint32_t max_cp;
+
+    in_range_t(uint32_t min, uint32_t max) : min_cp(min), max_cp(max) {}
+
+    bool operator()(const CharInfo& info) const {
+        return info.codepoint >= min_cp && info.codepoint <= max_cp;
+    }
+};
+
 /**
  * @brief Check if character codepoint is in range
  * @param min_cp Minimum codepoint (inclusive)
@@ -897,62 +2760,95 @@ inline std::function<bool(const CharInfo&)> has_codepoint(uint32_t codepoint) {
  * @return Predicate function that returns true if character is in the specified range
  */
 inline std::function<bool(const CharInfo&)> in_range(uint32_t min_cp, uint32_t max_cp) {
-    return [min_cp, max_cp](const CharInfo& info) { 
-        return info.codepoint >= min_cp && info.codepoint <= max_cp; 
-    };
+    return in_range_t(min_cp, max_cp);
 }
 
+/// Functor form of is_digit_ascii()
+struct is_digit_ascii_t {
+    bool operator()(const CharInfo& info) const {
+        return info.codepoint >= '0' && info.codepoint <= '9';
+    }
+};
+
 /**
  * @brief Check if character is ASCII digit
  * @return Predicate function that returns true for ASCII digits (0-9)
  */
 inline std::function<bool(const CharInfo&)> is_digit_ascii() {
-    return in_range('0', '9');
+    return is_digit_ascii_t();
 }
 
+/// Functor form of is_alpha_ascii()
+struct is_alpha_ascii_t {
+    bool operator()(const CharInfo& info) const {
+        return (info.codepoint >= 'A' && info.codepoint <= 'Z') ||
+                   (info.codepoint >= 'a' && info.codepoint <= 'z');
+    }
+};
+
 /**
  * @brief Check if character is ASCII letter
  * @return Predicate function that returns true for ASCII letters (A-Z, a-z)
  */
 inline std::function<bool(const CharInfo&)> is_alpha_ascii() {
-    return [](const CharInfo& info) {
-        return (info.codepoint >= 'A' && info.codepoint <= 'Z') ||
-               (info.codepoint >= 'a' && info.codepoint <= 'z');
-    };
+    return is_alpha_ascii_t();
 }
 
+/// Functor form of is_alphanum_ascii()
+struct is_alphanum_ascii_t {
+    bool operator()(const CharInfo& info) const {
+        return (info.codepoint >= 'A' && info.codepoint <= 'Z') ||
+                   (info.codepoint >= 'a' && info.codepoint <= 'z') ||
+                   (info.codepoint >= '0' && info.codepoint <= '9');
+    }
+};
+
 /**
  * @brief Check if character is ASCII alphanumeric
  * @return Predicate function that returns true for ASCII letters and digits (A-Z, a-z, 0-9)
  */
 inline std::function<bool(const CharInfo&)> is_alphanum_ascii() {
-    return [](const CharInfo& info) {
-        return (info.codepoint >= 'A' && info.codepoint <= 'Z') ||
-               (info.codepoint >= 'a' && info.codepoint <= 'z') ||
-               (info.codepoint >= '0' && info.codepoint <= '9');
-    };
+    return is_alphanum_ascii_t();
 }
 
+/// Functor form of is_lowercase_ascii()
+struct is_lowercase_ascii_t {
+    bool operator()(const CharInfo& info) const {
+        return info.codepoint >= 'a' && info.codepoint <= 'z';
+    }
+};
+
 /**
  * @brief Check if character is ASCII lowercase letter
  * @return Predicate function that returns true for ASCII lowercase letters (a-z)
  */
 inline std::function<bool(const CharInfo&)> is_lowercase_ascii() {
-    return [](const CharInfo& info) {
-        return (info.codepoint >= 'a' && info.codepoint <= 'z');
-    };
+    return is_lowercase_ascii_t();
 }
 
+/// Functor form of is_uppercase_ascii()
+struct is_uppercase_ascii_t {
+    bool operator()(const CharInfo& info) const {
+        return info.codepoint >= 'A' && info.codepoint <= 'Z';
+    }
+};
+
 /**
  * @brief Check if character is ASCII uppercase letter
  * @return Predicate function that returns true for ASCII uppercase letters (A-Z)
  */
 inline std::function<bool(const CharInfo&)> is_uppercase_ascii() {
-    return [](const CharInfo& info) {
-        return (info.codepoint >= 'A' && info.codepoint <= 'Z');
-    };
+    return is_uppercase_ascii_t();
 }
 
+/// Functor form of is_whitespace_ascii()
+struct is_whitespace_ascii_t {
+    bool operator()(const CharInfo& info) const {
+        return info.codepoint == ' ' || info.codepoint == '\t' ||
+                   info.codepoint == '\n' || info.codepoint == '\r';
+    }
+};
+
 /**
  * @brief Check if character is ASCII whitespace
  * @return Predicate function that returns true for ASCII whitespace characters (space, tab, newline, carriage return)
@@ -964,244 +2860,3013 @@ inline std::function<bool(const CharInfo&)> is_uppercase_ascii() {
  * - Carriage return (U+000D)
  */
 inline std::function<bool(const CharInfo&)> is_whitespace_ascii() {
-    return [](const CharInfo& info) {
-        return info.codepoint == ' ' || info.codepoint == '\t' || 
-               info.codepoint == '\n' || info.codepoint == '\r';
-    };
+    return is_whitespace_ascii_t();
 }
 
-/**
- * @brief Check if character is an emoji
- * @return Predicate function that returns true for Unicode emoji characters
- * 
- * Detects emoji characters based on Unicode emoji ranges including:
- * - Emoticons (U+1F600-U+1F64F): 😀😃😄😁😆😅😂🤣😊😇🙂🙃😉😌😍🥰😘😗😙😚😋😛😝😜🤪🤨🧐🤓😎🤩
- * - Miscellaneous Symbols and Pictographs (U+1F300-U+1F5FF): 🌍🌎🌏🌐🗺🏔⛰🌋🗻🏕🏖🏜🏝🏞🏟🏛🏗🏘🏚🏠🏡
- * - Transport and Map Symbols (U+1F680-U+1F6FF): 🚀🛸🚁🚂🚃🚄🚅🚆🚇🚈🚉🚊🚝🚞🚋🚃🚄🚅🚆🚇🚈🚉
- * - Supplemental Symbols and Pictographs (U+1F900-U+1F9FF): 🤖🦄🦅🦆🦇🦈🦉🦊🦋🦌🦍🦎🦏🦐🦑🦒🦓🦔🦕🦖🦗
- * - Regional Indicator Symbols for flags (U+1F1E6-U+1F1FF): 🇦🇧🇨🇩🇪🇫🇬🇭🇮🇯🇰🇱🇲🇳🇴🇵🇶🇷🇸🇹🇺🇻🇼🇽🇾🇿
- * - Selected symbols from other ranges: ⭐❤️⚡☀️❄️✨⚽⬆️⬇️⬅️➡️
+/// Functor form of has_category()
+struct has_category_t {
+    uint32_t mask;
+
+    explicit has_category_t(GeneralCategory category) : mask(1u << static_cast<uint8_t>(category)) {}
+
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & mask) != 0;
+    }
+};
+
+/**
+ * @brief Check if character has a General_Category
+ * @param category The category to match
+ * @return Predicate function that returns true for valid characters of the category
+ */
+inline std::function<bool(const CharInfo&)> has_category(GeneralCategory category) {
+    return has_category_t(category);
+}
+
+/// Functor form of is_letter()
+struct is_letter_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & details::letter_categories) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is a Unicode letter
+ * @return Predicate function that returns true for General_Category L (Lu, Ll, Lt, Lm, Lo)
+ *
+ * @code
+ * std::string letters;
+ * u8scan::copy_if(u8"Ünïcödé 123 世界!", std::back_inserter(letters), u8scan::predicates::is_letter());
+ * // letters == "Ünïcödé世界"
+ * @endcode
+ */
+inline std::function<bool(const CharInfo&)> is_letter() {
+    return is_letter_t();
+}
+
+/// Functor form of is_uppercase()
+struct is_uppercase_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & (1u << details::ucd::category_lu)) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is a Unicode uppercase letter
+ * @return Predicate function that returns true for General_Category Lu
+ */
+inline std::function<bool(const CharInfo&)> is_uppercase() {
+    return is_uppercase_t();
+}
+
+/// Functor form of is_lowercase()
+struct is_lowercase_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & (1u << details::ucd::category_ll)) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is a Unicode lowercase letter
+ * @return Predicate function that returns true for General_Category Ll
+ */
+inline std::function<bool(const CharInfo&)> is_lowercase() {
+    return is_lowercase_t();
+}
+
+/// Functor form of is_mark()
+struct is_mark_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & details::mark_categories) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is a Unicode combining mark
+ * @return Predicate function that returns true for General_Category M (Mn, Mc, Me)
+ */
+inline std::function<bool(const CharInfo&)> is_mark() {
+    return is_mark_t();
+}
+
+/// Functor form of is_digit()
+struct is_digit_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & (1u << details::ucd::category_nd)) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is a Unicode decimal digit
+ * @return Predicate function that returns true for General_Category Nd (0-9, ٠-٩, ０-９, ...)
+ */
+inline std::function<bool(const CharInfo&)> is_digit() {
+    return is_digit_t();
+}
+
+/// Functor form of is_number()
+struct is_number_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & details::number_categories) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is a Unicode number
+ * @return Predicate function that returns true for General_Category N (Nd, Nl, No: digits, Ⅻ, ½, ², ...)
+ */
+inline std::function<bool(const CharInfo&)> is_number() {
+    return is_number_t();
+}
+
+/// Functor form of is_alphanum()
+struct is_alphanum_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & (details::letter_categories | details::number_categories)) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is a Unicode letter or number
+ * @return Predicate function that returns true for General_Category L or N
+ */
+inline std::function<bool(const CharInfo&)> is_alphanum() {
+    return is_alphanum_t();
+}
+
+/// Functor form of is_punct()
+struct is_punct_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & details::punctuation_categories) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is Unicode punctuation
+ * @return Predicate function that returns true for General_Category P (Pc, Pd, Ps, Pe, Pi, Pf, Po)
+ */
+inline std::function<bool(const CharInfo&)> is_punct() {
+    return is_punct_t();
+}
+
+/// Functor form of is_symbol()
+struct is_symbol_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & details::symbol_categories) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is a Unicode symbol
+ * @return Predicate function that returns true for General_Category S (Sm, Sc, Sk, So)
+ */
+inline std::function<bool(const CharInfo&)> is_symbol() {
+    return is_symbol_t();
+}
+
+/// Functor form of is_whitespace()
+struct is_whitespace_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & details::separator_categories) != 0 ||
+                   (info.codepoint >= 0x09 && info.codepoint <= 0x0D) || (info.codepoint == 0x85 && info.is_valid_utf8);
+    }
+};
+
+/**
+ * @brief Check if character is Unicode whitespace
+ * @return Predicate function that returns true for White_Space characters
+ *
+ * White_Space characters are the separators (General_Category Zs, Zl, Zp: space, no-break
+ * space, ideographic space, U+2028, ...) and the controls U+0009 to U+000D and U+0085.
+ */
+inline std::function<bool(const CharInfo&)> is_whitespace() {
+    return is_whitespace_t();
+}
+
+/// Functor form of is_control()
+struct is_control_t {
+    bool operator()(const CharInfo& info) const {
+        return (details::category_bit(info) & (1u << details::ucd::category_cc)) != 0;
+    }
+};
+
+/**
+ * @brief Check if character is a control character
+ * @return Predicate function that returns true for General_Category Cc (U+0000 to U+001F, U+007F to U+009F)
+ */
+inline std::function<bool(const CharInfo&)> is_control() {
+    return is_control_t();
+}
+
+/// Functor form of is_emoji()
+struct is_emoji_t {
+    bool operator()(const CharInfo& info) const {
+        return info.is_valid_utf8 && details::ucd::is_emoji(info.codepoint);
+    }
+};
+
+/**
+ * @brief Check if character is an emoji
+ * @return Predicate function that returns true for Unicode emoji characters
+ *
+ * Emoji are the characters with the Extended_Pictographic or Emoji_Presentation property
+ * (UTS #51): pictographs such as 🌍 🚀 ☕ ⭐ ❤ ✈, the regional indicators that make up flags
+ * 🇺🇸 and the skin tone modifiers. Keycap bases (digits, # and *) are not emoji. The plain text
+ * symbols © ® ™ are not emoji either, they are only shown as emoji with U+FE0F. Each character
+ * of a sequence is tested on its own; invalid bytes are not emoji.
+ *
+ * Classification is a single lookup in a generated bitset. To count emoji in a whole string,
+ * count_emoji() is faster.
+ *
+ * @code
+ * auto range = u8scan::make_char_range("Hello 🌍 World! 🚀");
+ * size_t emoji_count = std::count_if(range.begin(), range.end(), u8scan::predicates::is_emoji());
+ * // emoji_count will be 2 (🌍 and 🚀)
+ * @endcode
+ */
+inline std::function<bool(const CharInfo&)> is_emoji() {
+    return is_emoji_t();
+}
+
+
+/**
+ * @brief Set of codepoints compiled from ASCII classes and codepoint ranges
+ *
+ * This is what any_of(), all_of() and not_() return when every operand is one of the ASCII
+ * class functors (is_digit_ascii_t, is_alpha_ascii_t, is_alphanum_ascii_t, is_lowercase_ascii_t,
+ * is_uppercase_ascii_t, is_whitespace_ascii_t), has_codepoint_t, in_range_t or a CharClass.
+ * Codepoints below 0x80 are kept in a 128-bit bitset and the others in a sorted list of
+ * disjoint ranges. Like in_range(), membership depends on CharInfo::codepoint only, so
+ * invalid bytes match when their byte value is in the set.
+ *
+ * u8scan::find_if() and u8scan::count_if() have overloads for CharClass that test ASCII
+ * bytes 16 at a time and only decode multi-byte characters.
+ *
+ * @code
+ * using namespace u8scan::predicates;
+ * auto identifier = any_of(is_alphanum_ascii_t(), has_codepoint_t('_'));   // A CharClass
+ * std::size_t pos = u8scan::find_if(input, not_(identifier));
+ * @endcode
+ */
+class CharClass {
+public:
+    typedef std::pair<uint32_t, uint32_t> Range;
+
+    CharClass() {
+        ascii_[0] = 0;
+        ascii_[1] = 0;
+    }
+
+    CharClass(uint32_t first, uint32_t last) : CharClass() {
+        insert_range(first, last);
+    }
+
+    CharClass& insert(uint32_t cp) {
+        return insert_range(cp, cp);
+    }
+
+    /// Add the codepoints [first, last], nothing if first > last
+    CharClass& insert_range(uint32_t first, uint32_t last) {
+        if (first > last) {
+            return *this;
+        }
+        for (uint32_t cp = first; cp <= last && cp < 0x80; ++cp) {
+            ascii_[cp >> 6] |= uint64_t(1) << (cp & 63);
+        }
+        if (last >= 0x80) {
+            ranges_.push_back(Range(std::max(first, uint32_t(0x80)), last));
+            merge_ranges();
+        }
+        update_byte_sets();
+        return *this;
+    }
+
+    bool contains(uint32_t cp) const {
+        if (cp < 0x80) {
+            return ((ascii_[cp >> 6] >> (cp & 63)) & 1) != 0;
+        }
+        auto it = std::upper_bound(ranges_.begin(), ranges_.end(), Range(cp, 0xFFFFFFFFu));
+        return it != ranges_.begin() && cp <= (it - 1)->second;
+    }
+
+    /// Overlong encodings of ASCII, which make_char_range() decodes, are not members
+    bool operator()(const CharInfo& info) const {
+        return contains(info.codepoint) && (info.codepoint >= 0x80 || info.byte_count == 1);
+    }
+
+    /// Sorted disjoint ranges of the members from U+0080 up
+    const std::vector<Range>& ranges() const {
+        return ranges_;
+    }
+
+    /// Union
+    CharClass operator|(const CharClass& other) const {
+        CharClass result(*this);
+        result.ascii_[0] |= other.ascii_[0];
+        result.ascii_[1] |= other.ascii_[1];
+        result.ranges_.insert(result.ranges_.end(), other.ranges_.begin(), other.ranges_.end());
+        result.merge_ranges();
+        result.update_byte_sets();
+        return result;
+    }
+
+    /// Intersection
+    CharClass operator&(const CharClass& other) const {
+        CharClass result;
+        result.ascii_[0] = ascii_[0] & other.ascii_[0];
+        result.ascii_[1] = ascii_[1] & other.ascii_[1];
+        auto a = ranges_.begin();
+        auto b = other.ranges_.begin();
+        while (a != ranges_.end() && b != other.ranges_.end()) {
+            uint32_t first = std::max(a->first, b->first);
+            uint32_t last = std::min(a->second, b->second);
+            if (first <= last) {
+                result.ranges_.push_back(Range(first, last));
+            }
+            if (a->second < b->second) {
+                ++a;
+            } else {
+                ++b;
+            }
+        }
+        result.update_byte_sets();
+        return result;
+    }
+
+    /// Complement over all 32-bit codepoint values
+    CharClass operator~() const {
+        CharClass result;
+        result.ascii_[0] = ~ascii_[0];
+        result.ascii_[1] = ~ascii_[1];
+        uint64_t next = 0x80;
+        for (const auto& range : ranges_) {
+            if (range.first > next) {
+                result.ranges_.push_back(Range(static_cast<uint32_t>(next), range.first - 1));
+            }
+            next = uint64_t(range.second) + 1;
+        }
+        if (next <= 0xFFFFFFFFu) {
+            result.ranges_.push_back(Range(static_cast<uint32_t>(next), 0xFFFFFFFFu));
+        }
+        result.update_byte_sets();
+        return result;
+    }
+
+    /**
+     * @brief Byte position of the first member character, like u8scan::find_if()
+     */
+    std::size_t find(const std::string& input) const {
+        const char* data = input.data();
+        std::size_t length = input.length();
+        std::size_t pos = details::detect_bom(input).size;
+        // Every non-ASCII byte stops the search when there are members above U+007F
+        while ((pos = search_bytes_.find_first(data, pos, length)) < length) {
+            if (static_cast<unsigned char>(data[pos]) < 0x80) {
+                return pos;
+            }
+            CharInfo info = details::extract_char_info(input, pos, true, true);
+            if ((*this)(info)) {
+                return pos;
+            }
+            pos += info.byte_count;
+        }
+        return std::string::npos;
+    }
+
+    /**
+     * @brief Number of member characters, like u8scan::count_if()
+     */
+    std::size_t count(const std::string& input) const {
+        const char* data = input.data();
+        std::size_t length = input.length();
+        std::size_t pos = details::detect_bom(input).size;
+        if (ranges_.empty()) {
+            // ASCII bytes are never part of a multi-byte character
+            return ascii_bytes_.count(data, pos, length);
+        }
+        std::size_t result = 0;
+        while (pos < length) {
+            std::size_t next = details::skip_ascii(data, pos, length);
+            result += ascii_bytes_.count(data, pos, next);
+            for (pos = next; pos < length && static_cast<unsigned char>(data[pos]) >= 0x80;) {
+                CharInfo info = details::extract_char_info(input, pos, true, true);
+                if ((*this)(info)) {
+                    ++result;
+                }
+                pos += info.byte_count;
+            }
+        }
+        return result;
+    }
+
+private:
+    uint64_t ascii_[2];                 ///< Members below 0x80
+    std::vector<Range> ranges_;         ///< Members from 0x80 up, sorted and disjoint
+    details::ByteSet ascii_bytes_;      ///< ASCII members as bytes
+    details::ByteSet search_bytes_;     ///< ASCII members, plus 0x80-0xFF if ranges_ is not empty
+
+    void merge_ranges() {
+        std::sort(ranges_.begin(), ranges_.end());
+        std::size_t out = 0;
+        for (std::size_t i = 1; i < ranges_.size(); ++i) {
+            if (ranges_[out].second == 0xFFFFFFFFu || ranges_[i].first <= ranges_[out].second + 1) {
+                ranges_[out].second = std::max(ranges_[out].second, ranges_[i].second);
+            } else {
+                ranges_[++out] = ranges_[i];
+            }
+        }
+        if (!ranges_.empty()) {
+            ranges_.resize(out + 1);
+        }
+    }
+
+    void update_byte_sets() {
+        ascii_bytes_ = details::ByteSet();
+        for (uint32_t b = 0; b < 0x80; ++b) {
+            if (!contains(b)) continue;
+            uint32_t last = b;
+            while (last + 1 < 0x80 && contains(last + 1)) {
+                ++last;
+            }
+            ascii_bytes_.insert_range(static_cast<unsigned char>(b), static_cast<unsigned char>(last));
+            b = last;
+        }
+        search_bytes_ = ascii_bytes_;
+        if (!ranges_.empty()) {
+            search_bytes_.insert_range(0x80, 0xFF);
+        }
+    }
+};
+
+} // namespace predicates
+
+namespace details {
+
+/// True for the predicates that any_of(), all_of() and not_() compile into a predicates::CharClass
+template<typename Predicate> struct is_char_class_operand : std::false_type {};
+template<> struct is_char_class_operand<predicates::is_digit_ascii_t> : std::true_type {};
+template<> struct is_char_class_operand<predicates::is_alpha_ascii_t> : std::true_type {};
+template<> struct is_char_class_operand<predicates::is_alphanum_ascii_t> : std::true_type {};
+template<> struct is_char_class_operand<predicates::is_lowercase_ascii_t> : std::true_type {};
+template<> struct is_char_class_operand<predicates::is_uppercase_ascii_t> : std::true_type {};
+template<> struct is_char_class_operand<predicates::is_whitespace_ascii_t> : std::true_type {};
+template<> struct is_char_class_operand<predicates::has_codepoint_t> : std::true_type {};
+template<> struct is_char_class_operand<predicates::in_range_t> : std::true_type {};
+template<> struct is_char_class_operand<predicates::CharClass> : std::true_type {};
+
+inline predicates::CharClass char_class_of(const predicates::is_digit_ascii_t&) {
+    return predicates::CharClass('0', '9');
+}
+
+inline predicates::CharClass char_class_of(const predicates::is_alpha_ascii_t&) {
+    return predicates::CharClass('A', 'Z').insert_range('a', 'z');
+}
+
+inline predicates::CharClass char_class_of(const predicates::is_alphanum_ascii_t&) {
+    return predicates::CharClass('0', '9').insert_range('A', 'Z').insert_range('a', 'z');
+}
+
+inline predicates::CharClass char_class_of(const predicates::is_lowercase_ascii_t&) {
+    return predicates::CharClass('a', 'z');
+}
+
+inline predicates::CharClass char_class_of(const predicates::is_uppercase_ascii_t&) {
+    return predicates::CharClass('A', 'Z');
+}
+
+inline predicates::CharClass char_class_of(const predicates::is_whitespace_ascii_t&) {
+    return predicates::CharClass(' ', ' ').insert('\t').insert('\n').insert('\r');
+}
+
+inline predicates::CharClass char_class_of(const predicates::has_codepoint_t& pred) {
+    return predicates::CharClass(pred.codepoint, pred.codepoint);
+}
+
+inline predicates::CharClass char_class_of(const predicates::in_range_t& pred) {
+    return predicates::CharClass(pred.min_cp, pred.max_cp);
+}
+
+inline const predicates::CharClass& char_class_of(const predicates::CharClass& pred) {
+    return pred;
+}
+
+/// Generic any_of() of two predicates
+template<typename First, typename Second>
+struct AnyOfPredicate {
+    First first;
+    Second second;
+
+    AnyOfPredicate(const First& f, const Second& s) : first(f), second(s) {}
+
+    bool operator()(const CharInfo& info) const {
+        return first(info) || second(info);
+    }
+};
+
+/// Generic all_of() of two predicates
+template<typename First, typename Second>
+struct AllOfPredicate {
+    First first;
+    Second second;
+
+    AllOfPredicate(const First& f, const Second& s) : first(f), second(s) {}
+
+    bool operator()(const CharInfo& info) const {
+        return first(info) && second(info);
+    }
+};
+
+/// Generic not_() of a predicate
+template<typename Predicate>
+struct NotPredicate {
+    Predicate pred;
+
+    explicit NotPredicate(const Predicate& p) : pred(p) {}
+
+    bool operator()(const CharInfo& info) const {
+        return !pred(info);
+    }
+};
+
+template<typename First, typename Second,
+         bool = is_char_class_operand<First>::value && is_char_class_operand<Second>::value>
+struct AnyOfCombiner {
+    typedef AnyOfPredicate<First, Second> type;
+    static type combine(const First& first, const Second& second) { return type(first, second); }
+};
+
+template<typename First, typename Second>
+struct AnyOfCombiner<First, Second, true> {
+    typedef predicates::CharClass type;
+    static type combine(const First& first, const Second& second) { return char_class_of(first) | char_class_of(second); }
+};
+
+template<typename First, typename Second,
+         bool = is_char_class_operand<First>::value && is_char_class_operand<Second>::value>
+struct AllOfCombiner {
+    typedef AllOfPredicate<First, Second> type;
+    static type combine(const First& first, const Second& second) { return type(first, second); }
+};
+
+template<typename First, typename Second>
+struct AllOfCombiner<First, Second, true> {
+    typedef predicates::CharClass type;
+    static type combine(const First& first, const Second& second) { return char_class_of(first) & char_class_of(second); }
+};
+
+template<typename Predicate, bool = is_char_class_operand<Predicate>::value>
+struct NotCombiner {
+    typedef NotPredicate<Predicate> type;
+    static type combine(const Predicate& pred) { return type(pred); }
+};
+
+template<typename Predicate>
+struct NotCombiner<Predicate, true> {
+    typedef predicates::CharClass type;
+    static type combine(const Predicate& pred) { return ~char_class_of(pred); }
+};
+
+/// Result type of any_of() and all_of(), combining the operands from the right
+template<typename First, typename... Rest>
+struct AnyOfResult {
+    typedef typename AnyOfCombiner<First, typename AnyOfResult<Rest...>::type>::type type;
+};
+
+template<typename Last>
+struct AnyOfResult<Last> {
+    typedef Last type;
+};
+
+template<typename First, typename... Rest>
+struct AllOfResult {
+    typedef typename AllOfCombiner<First, typename AllOfResult<Rest...>::type>::type type;
+};
+
+template<typename Last>
+struct AllOfResult<Last> {
+    typedef Last type;
+};
+
+} // namespace details
+
+namespace predicates {
+
+template<typename Predicate>
+inline Predicate any_of(Predicate pred) {
+    return pred;
+}
+
+/**
+ * @brief Predicate matching characters that match any of the given predicates
+ *
+ * When all predicates are ASCII class functors, has_codepoint_t, in_range_t or CharClass, the
+ * result is a CharClass, which u8scan::find_if() and u8scan::count_if() scan with SIMD.
+ * Otherwise the predicates are called in order until one matches; consecutive class operands
+ * at the end of the list are still merged into one CharClass.
+ *
+ * @code
+ * auto word = u8scan::predicates::any_of(is_alphanum_ascii_t(), has_codepoint_t('_'), in_range_t(0x4E00, 0x9FFF));
+ * @endcode
+ */
+template<typename First, typename Second, typename... Rest>
+inline typename details::AnyOfResult<First, Second, Rest...>::type any_of(First first, Second second, Rest... rest) {
+    return details::AnyOfCombiner<First, typename details::AnyOfResult<Second, Rest...>::type>::combine(
+        first, any_of(second, rest...));
+}
+
+template<typename Predicate>
+inline Predicate all_of(Predicate pred) {
+    return pred;
+}
+
+/**
+ * @brief Predicate matching characters that match all of the given predicates
+ *
+ * Compiles into a CharClass under the same conditions as any_of().
+ *
+ * @code
+ * auto ascii_consonant = u8scan::predicates::all_of(is_alpha_ascii_t(), not_(any_of(has_codepoint_t('a'), has_codepoint_t('e'))));
+ * @endcode
+ */
+template<typename First, typename Second, typename... Rest>
+inline typename details::AllOfResult<First, Second, Rest...>::type all_of(First first, Second second, Rest... rest) {
+    return details::AllOfCombiner<First, typename details::AllOfResult<Second, Rest...>::type>::combine(
+        first, all_of(second, rest...));
+}
+
+/**
+ * @brief Predicate matching characters that do not match the given predicate
+ *
+ * The complement of a class operand is a CharClass covering every other codepoint value,
+ * including the byte values that invalid bytes are reported with.
+ */
+template<typename Predicate>
+inline typename details::NotCombiner<Predicate>::type not_(Predicate pred) {
+    return details::NotCombiner<Predicate>::combine(pred);
+}
+
+} // namespace predicates
+
+/**
+ * @brief Byte position of the first character matching a predicate, or std::string::npos
+ *
+ * Characters are visited like make_char_range(input) does, skipping a BOM.
+ */
+template<typename Predicate>
+inline std::size_t find_if(const std::string& input, Predicate pred) {
+    auto range = make_char_range(input);
+    auto it = std::find_if(range.begin(), range.end(), pred);
+    return it == range.end() ? std::string::npos : it.position();
+}
+
+/**
+ * @brief find_if() for a CharClass: ASCII bytes are tested 16 at a time
+ */
+inline std::size_t find_if(const std::string& input, const predicates::CharClass& pred) {
+    return pred.find(input);
+}
+
+/**
+ * @brief Number of characters matching a predicate
+ *
+ * Characters are visited like make_char_range(input) does, skipping a BOM.
+ */
+template<typename Predicate>
+inline std::size_t count_if(const std::string& input, Predicate pred) {
+    auto range = make_char_range(input);
+    return static_cast<std::size_t>(std::count_if(range.begin(), range.end(), pred));
+}
+
+/**
+ * @brief count_if() for a CharClass: ASCII bytes are counted 16 at a time
+ */
+inline std::size_t count_if(const std::string& input, const predicates::CharClass& pred) {
+    return pred.count(input);
+}
+
+/**
+ * @brief Set of Unicode codepoints for large character sets
+ *
+ * Meant for sets of thousands of codepoints, such as the characters allowed in identifiers
+ * or a confusables list, where chaining in_range() predicates would be slow. Membership is
+ * tested with a 128-bit bitmap for ASCII, a two-level bitmap for the BMP (one 256-bit block
+ * per 256 codepoints, with empty blocks shared) and binary search over sorted ranges above
+ * U+FFFF. Codepoints beyond U+10FFFF are never members.
+ *
+ * Sets are built with insert() and insert_range(), and combined with `|` (union) and `&`
+ * (intersection). As a predicate a CodepointSet matches valid characters in the set; invalid
+ * bytes never match. span_matching() measures the longest prefix of a string inside a set.
+ *
+ * @code
+ * u8scan::CodepointSet identifier;
+ * identifier.insert_range('a', 'z').insert_range('A', 'Z').insert('_').insert_range(0x4E00, 0x9FFF);
+ * std::size_t bytes = u8scan::span_matching(u8"變數_name = 1", identifier);   // 11
+ * @endcode
+ */
+class CodepointSet {
+public:
+    typedef std::pair<uint32_t, uint32_t> Range;
+
+    CodepointSet() : blocks_(4, 0) {
+        ascii_[0] = 0;
+        ascii_[1] = 0;
+        std::fill(stage1_, stage1_ + 256, static_cast<uint16_t>(0));
+        update_stop_bytes();
+    }
+
+    CodepointSet& insert(uint32_t cp) {
+        return insert_range(cp, cp);
+    }
+
+    /// Add the codepoints [first, last] up to U+10FFFF, nothing if first > last
+    CodepointSet& insert_range(uint32_t first, uint32_t last) {
+        last = std::min(last, uint32_t(0x10FFFF));
+        if (first > last) {
+            return *this;
+        }
+        for (uint32_t cp = first; cp <= std::min(last, uint32_t(0xFFFF));) {
+            // Set the bits of one 64-bit word at a time
+            uint32_t word_last = std::min(last, cp | 63);
+            uint64_t bits = ~uint64_t(0) >> (63 - (word_last - cp)) << (cp & 63);
+            writable_block(cp >> 8)[(cp >> 6) & 3] |= bits;
+            if (cp < 0x80) {
+                ascii_[cp >> 6] |= bits;
+            }
+            cp = word_last + 1;
+        }
+        if (last > 0xFFFF) {
+            supplementary_.push_back(Range(std::max(first, uint32_t(0x10000)), last));
+            merge_ranges(supplementary_);
+        }
+        if (first < 0x80) {
+            update_stop_bytes();
+        }
+        return *this;
+    }
+
+    bool contains(uint32_t cp) const {
+        if (cp < 0x80) {
+            return ((ascii_[cp >> 6] >> (cp & 63)) & 1) != 0;
+        }
+        if (cp < 0x10000) {
+            return ((blocks_[(static_cast<std::size_t>(stage1_[cp >> 8]) << 2) | ((cp >> 6) & 3)] >> (cp & 63)) & 1) != 0;
+        }
+        auto it = std::upper_bound(supplementary_.begin(), supplementary_.end(), Range(cp, 0xFFFFFFFFu));
+        return it != supplementary_.begin() && cp <= (it - 1)->second;
+    }
+
+    /// Only well-formed characters, as span() decodes them: not overlong forms or encoded surrogates
+    bool operator()(const CharInfo& info) const {
+        uint32_t cp = info.codepoint;
+        std::size_t shortest = cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+        return info.is_valid_utf8 && info.byte_count == shortest && (cp < 0xD800 || cp > 0xDFFF) && contains(cp);
+    }
+
+    /// Number of codepoints in the set
+    std::size_t size() const {
+        std::size_t result = 0;
+        for (std::size_t block = 0; block < 256; ++block) {
+            const uint64_t* words = &blocks_[static_cast<std::size_t>(stage1_[block]) << 2];
+            for (int w = 0; w < 4; ++w) {
+                result += details::popcount32(static_cast<uint32_t>(words[w])) +
+                          details::popcount32(static_cast<uint32_t>(words[w] >> 32));
+            }
+        }
+        for (const auto& range : supplementary_) {
+            result += range.second - range.first + 1;
+        }
+        return result;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    CodepointSet& operator|=(const CodepointSet& other) {
+        return *this = *this | other;
+    }
+
+    CodepointSet& operator&=(const CodepointSet& other) {
+        return *this = *this & other;
+    }
+
+    /// Union
+    CodepointSet operator|(const CodepointSet& other) const {
+        CodepointSet result;
+        result.combine_bmp(*this, other, false);
+        result.supplementary_ = supplementary_;
+        result.supplementary_.insert(result.supplementary_.end(), other.supplementary_.begin(), other.supplementary_.end());
+        merge_ranges(result.supplementary_);
+        return result;
+    }
+
+    /// Intersection
+    CodepointSet operator&(const CodepointSet& other) const {
+        CodepointSet result;
+        result.combine_bmp(*this, other, true);
+        auto a = supplementary_.begin();
+        auto b = other.supplementary_.begin();
+        while (a != supplementary_.end() && b != other.supplementary_.end()) {
+            uint32_t first = std::max(a->first, b->first);
+            uint32_t last = std::min(a->second, b->second);
+            if (first <= last) {
+                result.supplementary_.push_back(Range(first, last));
+            }
+            if (a->second < b->second) {
+                ++a;
+            } else {
+                ++b;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Byte length of the longest prefix of input inside the set, like span_matching()
+     */
+    std::size_t span(const std::string& input) const {
+        const char* data = input.data();
+        std::size_t length = input.length();
+        std::size_t pos = details::detect_bom(input).size;
+        while ((pos = stop_bytes_.find_first(data, pos, length)) < length) {
+            // Decode the run of multi-byte characters, then check the ASCII byte after it
+            while (static_cast<unsigned char>(data[pos]) >= 0x80) {
+                bool valid;
+                std::size_t bytes = details::utf8_sequence_length(data, pos, length, valid);
+                if (!valid || !contains(details::decode_utf8(data + pos, bytes))) {
+                    return pos;
+                }
+                pos += bytes;
+                if (pos == length) {
+                    return length;
+                }
+            }
+            if (!contains(static_cast<unsigned char>(data[pos]))) {
+                return pos;
+            }
+            ++pos;
+        }
+        return length;
+    }
+
+private:
+    uint64_t ascii_[2];                 ///< Members below 0x80
+    uint16_t stage1_[256];              ///< Block of blocks_ for each 256 BMP codepoints, 0 is the shared empty block
+    std::vector<uint64_t> blocks_;      ///< 256-bit blocks, four words each
+    std::vector<Range> supplementary_;  ///< Members above U+FFFF, sorted and disjoint
+    details::ByteSet stop_bytes_;       ///< ASCII non-members and all bytes from 0x80 up
+
+    uint64_t* writable_block(uint32_t block) {
+        if (stage1_[block] == 0) {
+            stage1_[block] = static_cast<uint16_t>(blocks_.size() / 4);
+            blocks_.resize(blocks_.size() + 4, 0);
+        }
+        return &blocks_[static_cast<std::size_t>(stage1_[block]) << 2];
+    }
+
+    void combine_bmp(const CodepointSet& a, const CodepointSet& b, bool intersect) {
+        for (uint32_t block = 0; block < 256; ++block) {
+            if (intersect ? (a.stage1_[block] == 0 || b.stage1_[block] == 0)
+                          : (a.stage1_[block] == 0 && b.stage1_[block] == 0)) {
+                continue;
+            }
+            const uint64_t* wa = &a.blocks_[static_cast<std::size_t>(a.stage1_[block]) << 2];
+            const uint64_t* wb = &b.blocks_[static_cast<std::size_t>(b.stage1_[block]) << 2];
+            uint64_t* out = writable_block(block);
+            for (int w = 0; w < 4; ++w) {
+                out[w] = intersect ? (wa[w] & wb[w]) : (wa[w] | wb[w]);
+            }
+        }
+        ascii_[0] = intersect ? (a.ascii_[0] & b.ascii_[0]) : (a.ascii_[0] | b.ascii_[0]);
+        ascii_[1] = intersect ? (a.ascii_[1] & b.ascii_[1]) : (a.ascii_[1] | b.ascii_[1]);
+        update_stop_bytes();
+    }
+
+    static void merge_ranges(std::vector<Range>& ranges) {
+        std::sort(ranges.begin(), ranges.end());
+        std::size_t out = 0;
+        for (std::size_t i = 1; i < ranges.size(); ++i) {
+            if (ranges[i].first <= ranges[out].second + 1) {
+                ranges[out].second = std::max(ranges[out].second, ranges[i].second);
+            } else {
+                ranges[++out] = ranges[i];
+            }
+        }
+        if (!ranges.empty()) {
+            ranges.resize(out + 1);
+        }
+    }
+
+    void update_stop_bytes() {
+        stop_bytes_ = details::ByteSet();
+        for (uint32_t b = 0; b < 0x80; ++b) {
+            if (contains(b)) continue;
+            uint32_t last = b;
+            while (last + 1 < 0x80 && !contains(last + 1)) {
+                ++last;
+            }
+            stop_bytes_.insert_range(static_cast<unsigned char>(b), static_cast<unsigned char>(last));
+            b = last;
+        }
+        stop_bytes_.insert_range(0x80, 0xFF);
+    }
+};
+
+/**
+ * @brief Byte length of the longest prefix of input whose characters are all in a set
+ * @return Number of bytes, including a leading BOM; input.length() if every character is in the set
+ *
+ * ASCII members are skipped 16 bytes at a time; only multi-byte characters are decoded. The
+ * span ends at the first character outside the set or the first ill-formed sequence (overlong
+ * forms, surrogates and truncated sequences included).
+ *
+ * @code
+ * u8scan::CodepointSet digits;
+ * digits.insert_range('0', '9').insert_range(0xFF10, 0xFF19);   // ASCII and fullwidth digits
+ * std::size_t bytes = u8scan::span_matching(u8"12３４ apples", digits);   // 8
+ * @endcode
+ */
+inline std::size_t span_matching(const std::string& input, const CodepointSet& set) {
+    return set.span(input);
+}
+
+/**
+ * @brief Statistics of a UTF-8 string, see analyze()
+ */
+struct TextStats {
+    std::size_t bytes;          ///< Size of the input, BOM included
+    std::size_t codepoints;     ///< Decoded characters, ASCII included; BOM and invalid bytes excluded
+    std::size_t ascii;          ///< Characters U+0000 to U+007F
+    std::size_t two_byte;       ///< Characters encoded in 2 bytes
+    std::size_t three_byte;     ///< Characters encoded in 3 bytes
+    std::size_t four_byte;      ///< Characters encoded in 4 bytes
+    std::size_t invalid_bytes;  ///< Bytes not part of a decodable sequence
+    std::size_t emoji;          ///< Characters matching predicates::is_emoji()
+    std::size_t whitespace;     ///< Characters matching predicates::is_whitespace()
+    bool has_bom;               ///< True if the input starts with a UTF-8 BOM
+    uint32_t max_codepoint;     ///< Largest decoded codepoint, 0 if there is none
+
+    TextStats() : bytes(0), codepoints(0), ascii(0), two_byte(0), three_byte(0), four_byte(0),
+                  invalid_bytes(0), emoji(0), whitespace(0), has_bom(false), max_codepoint(0) {}
+};
+
+namespace details {
+
+/**
+ * @brief Largest byte value in data[pos, end), which must all be ASCII, or floor if it is larger
+ */
+inline unsigned char max_ascii_byte(const char* data, std::size_t pos, std::size_t end, unsigned char floor) {
+    unsigned char result = floor;
+#if defined(U8SCAN_HAS_SSE2)
+    if (pos + 16 <= end) {
+        __m128i max = _mm_setzero_si128();
+        for (; pos + 16 <= end; pos += 16) {
+            max = _mm_max_epu8(max, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+        }
+        // Bytes are below 0x80, so the signed 16-bit maximum of the zero-extended halves works
+        max = _mm_max_epi16(_mm_unpacklo_epi8(max, _mm_setzero_si128()), _mm_unpackhi_epi8(max, _mm_setzero_si128()));
+        max = _mm_max_epi16(max, _mm_srli_si128(max, 8));
+        max = _mm_max_epi16(max, _mm_srli_si128(max, 4));
+        max = _mm_max_epi16(max, _mm_srli_si128(max, 2));
+        result = std::max(result, static_cast<unsigned char>(_mm_cvtsi128_si32(max) & 0xFF));
+    }
+#endif
+    for (; pos < end; ++pos) {
+        result = std::max(result, static_cast<unsigned char>(data[pos]));
+    }
+    return result;
+}
+
+/**
+ * @brief ASCII White_Space bytes: U+0009 to U+000D and space
+ */
+inline const ByteSet& ascii_whitespace_set() {
+    static const ByteSet set = ByteSet().insert_range(0x09, 0x0D).insert(' ');
+    return set;
+}
+
+} // namespace details
+
+/**
+ * @brief Compute character statistics of a UTF-8 string in a single pass
+ * @param input The UTF-8 string to analyze
+ * @return Byte, codepoint, sequence length, invalid byte, emoji and whitespace counts, BOM and largest codepoint
+ *
+ * Replaces calling length() and several count_if() over the same string. ASCII runs are found
+ * 16 bytes at a time and tallied in bulk (whitespace with a vectorized byte count); only
+ * multi-byte characters are decoded one by one. Characters are decoded as by make_char_range(),
+ * so the counts match the iterator-based ones:
+ * - codepoints + invalid_bytes == length(input)
+ * - ascii, codepoints, emoji and whitespace equal count_if() with is_ascii(), is_valid(),
+ *   is_emoji() and is_whitespace() over make_char_range(input)
+ *
+ * Like make_char_range(), decoding checks lead and continuation bytes but not overlong forms
+ * or surrogates; use sanitize_utf8() for a strict check.
+ *
+ * @code
+ * u8scan::TextStats stats = u8scan::analyze(u8"Hello 世界 🌍!");
+ * // stats.codepoints == 11, stats.ascii == 8, stats.three_byte == 2, stats.four_byte == 1,
+ * // stats.emoji == 1, stats.whitespace == 2, stats.max_codepoint == 0x1F30D
+ * @endcode
+ */
+inline TextStats analyze(const std::string& input) {
+    TextStats stats;
+    const char* data = input.data();
+    std::size_t length = input.length();
+    stats.bytes = length;
+    stats.has_bom = details::detect_bom(input).found;
+    std::size_t pos = stats.has_bom ? 3 : 0;
+    const details::ByteSet& whitespace = details::ascii_whitespace_set();
+    predicates::is_whitespace_t is_whitespace;
+    unsigned char max_ascii = 0;
+    while (pos < length) {
+        std::size_t next = details::skip_ascii(data, pos, length);
+        if (next > pos) {
+            stats.ascii += next - pos;
+            stats.whitespace += whitespace.count(data, pos, next);
+            if (max_ascii < 0x7F) {
+                max_ascii = details::max_ascii_byte(data, pos, next, max_ascii);
+            }
+        }
+        for (pos = next; pos < length && static_cast<unsigned char>(data[pos]) >= 0x80;) {
+            CharInfo info = details::extract_char_info(input, pos, true, true);
+            pos += info.byte_count;
+            if (!info.is_valid_utf8) {
+                ++stats.invalid_bytes;
+                continue;
+            }
+            if (info.byte_count == 2) {
+                ++stats.two_byte;
+            } else if (info.byte_count == 3) {
+                ++stats.three_byte;
+            } else {
+                ++stats.four_byte;
+            }
+            if (info.byte_count >= 3 && details::ucd::is_emoji(info.codepoint)) {
+                ++stats.emoji;
+            }
+            if (is_whitespace(info)) {
+                ++stats.whitespace;
+            }
+            stats.max_codepoint = std::max(stats.max_codepoint, info.codepoint);
+        }
+    }
+    stats.codepoints = stats.ascii + stats.two_byte + stats.three_byte + stats.four_byte;
+    if (stats.ascii > 0) {
+        stats.max_codepoint = std::max(stats.max_codepoint, static_cast<uint32_t>(max_ascii));
+    }
+    return stats;
+}
+
+/**
+ * @brief Script property (UAX #24) of a code point
+ *
+ * One lookup in the generated two-stage table of u8scan_tables.h. Code points shared by several
+ * scripts (digits, punctuation, symbols) are Script::Common, combining marks that take the script
+ * of their base are Script::Inherited, and unassigned code points are Script::Unknown.
+ *
+ * @code
+ * u8scan::script('a');      // Script::Latin
+ * u8scan::script(0x4E16);   // Script::Han
+ * u8scan::script('7');      // Script::Common
+ * @endcode
+ */
+inline Script script(uint32_t cp) {
+    return static_cast<Script>(details::ucd::script(cp));
+}
+
+/**
+ * @brief Long name of a Script value as in the UCD, e.g. "Latin" or "Old_Italic"
+ */
+inline const char* script_name(Script value) {
+    return details::ucd::script_name(static_cast<std::size_t>(value));
+}
+
+/**
+ * @brief Number of characters per script of a string, see script_histogram()
+ */
+struct ScriptHistogram {
+    std::size_t counts[details::ucd::script_count];     ///< Characters per script, indexed by the Script value
+
+    ScriptHistogram() {
+        std::fill(counts, counts + details::ucd::script_count, static_cast<std::size_t>(0));
+    }
+
+    std::size_t count(Script value) const {
+        return counts[static_cast<std::size_t>(value)];
+    }
+
+    /**
+     * @brief Script with the most characters, not counting Common, Inherited and Unknown
+     * @return The first such script in Script order on ties, Script::Common if there is none
+     */
+    Script dominant() const {
+        std::size_t best = static_cast<std::size_t>(Script::Common);
+        for (std::size_t i = static_cast<std::size_t>(Script::Inherited) + 1; i < details::ucd::script_count; ++i) {
+            if (counts[i] > 0 && (best == static_cast<std::size_t>(Script::Common) || counts[i] > counts[best])) {
+                best = i;
+            }
+        }
+        return static_cast<Script>(best);
+    }
+};
+
+namespace details {
+
+/**
+ * @brief ASCII letters, the only ASCII characters with Script=Latin
+ */
+inline const ByteSet& ascii_latin_set() {
+    static const ByteSet set = ByteSet().insert_range('A', 'Z').insert_range('a', 'z');
+    return set;
+}
+
+} // namespace details
+
+/**
+ * @brief Count the characters of each script in a UTF-8 string in a single pass
+ * @param input The UTF-8 string to classify
+ * @return Counts per script and the dominant script, without allocating
+ *
+ * Meant for routing documents by writing system, e.g. to a language-specific analyzer. ASCII
+ * runs are found 16 bytes at a time and tallied in bulk: their letters are Latin and everything
+ * else is Common. Multi-byte characters are decoded and looked up in the generated Script
+ * table. A BOM and invalid bytes are not counted.
+ *
+ * @code
+ * u8scan::ScriptHistogram histogram = u8scan::script_histogram(u8"Привет, мир! Hello");
+ * histogram.count(u8scan::Script::Cyrillic);   // 9
+ * histogram.count(u8scan::Script::Latin);      // 5
+ * histogram.dominant();                        // Script::Cyrillic
+ * @endcode
+ */
+inline ScriptHistogram script_histogram(const std::string& input) {
+    ScriptHistogram histogram;
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t pos = details::detect_bom(input).size;
+    const details::ByteSet& latin = details::ascii_latin_set();
+    std::size_t& latin_count = histogram.counts[static_cast<std::size_t>(Script::Latin)];
+    std::size_t& common_count = histogram.counts[static_cast<std::size_t>(Script::Common)];
+    while (pos < length) {
+        std::size_t next = details::skip_ascii(data, pos, length);
+        if (next > pos) {
+            std::size_t letters = latin.count(data, pos, next);
+            latin_count += letters;
+            common_count += next - pos - letters;
+        }
+        for (pos = next; pos < length && static_cast<unsigned char>(data[pos]) >= 0x80;) {
+            CharInfo info = details::extract_char_info(input, pos, true, true);
+            pos += info.byte_count;
+            if (info.is_valid_utf8) {
+                ++histogram.counts[details::ucd::script(info.codepoint)];
+            }
+        }
+    }
+    return histogram;
+}
+
+/**
+ * @brief Zero-based line and column of a byte offset, see LineIndex
+ */
+struct LinePosition {
+    std::size_t line;       ///< Line number, from 0
+    std::size_t column;     ///< Characters (code points) before the offset on its line, from 0
+};
+
+namespace details {
+
+/**
+ * @brief Number of characters decoded from data[pos] before the one holding offset, as by make_char_range()
+ */
+inline std::size_t count_columns(const char* data, std::size_t pos, std::size_t offset, std::size_t length) {
+    std::size_t column = 0;
+    while (pos < offset) {
+        std::size_t next = skip_ascii(data, pos, offset);
+        column += next - pos;
+        for (pos = next; pos < offset && static_cast<unsigned char>(data[pos]) >= 0x80; ++column) {
+            pos += decoded_sequence_length(data, pos, length);
+            if (pos > offset) {
+                return column;      // The offset is inside this character
+            }
+        }
+    }
+    return column;
+}
+
+} // namespace details
+
+/**
+ * @brief Index of line starts for mapping byte offsets to line and column
+ *
+ * Built once with a vectorized search for '\n' (32 bytes per step), the index maps a byte
+ * offset to its line by binary search over the line starts, and its column by decoding from the
+ * start of the line, skipping ASCII runs 16 bytes at a time; the byte offset of a line is a
+ * lookup. Meant for error reports of parsers over large inputs, instead of rescanning from the
+ * start with a CharRange.
+ *
+ * Lines end after '\n', so "\r\n" line endings work as well; a lone '\r' is not a line break.
+ * Text after the last '\n' is a line of its own, even if it is empty. Lines and columns count
+ * from 0, and a BOM at the start of the input is not a column. The index keeps a pointer to
+ * the data, which must outlive it; a memory-mapped file can be indexed through the pointer and
+ * length constructor.
+ *
+ * @code
+ * std::string source = "let x = 1;\nlet y = \"世界\" +;\n";
+ * u8scan::LineIndex index(source);
+ * u8scan::LinePosition pos = index.position(source.find('+'));   // line 1, column 13
+ * std::size_t second_line = index.line_start(1);                   // 11
+ * @endcode
+ */
+class LineIndex {
+public:
+    explicit LineIndex(const std::string& input) : data_(input.data()), length_(input.length()) {
+        build();
+    }
+
+    /// The index points into the string, so it cannot be built from a temporary
+    LineIndex(std::string&&) = delete;
+
+    LineIndex(const char* data, std::size_t length) : data_(data), length_(length) {
+        build();
+    }
+
+    /// Number of lines, at least 1
+    std::size_t line_count() const {
+        return starts_.size();
+    }
+
+    /**
+     * @brief Byte offset of the first byte of a line
+     * @throws std::out_of_range if line >= line_count()
+     */
+    std::size_t line_start(std::size_t line) const {
+        if (line >= starts_.size()) {
+            throw std::out_of_range("Line out of range");
+        }
+        return starts_[line];
+    }
+
+    /**
+     * @brief Byte offset of the end of a line: its '\n', or the input length for the last line
+     * @throws std::out_of_range if line >= line_count()
+     */
+    std::size_t line_end(std::size_t line) const {
+        if (line >= starts_.size()) {
+            throw std::out_of_range("Line out of range");
+        }
+        return line + 1 < starts_.size() ? starts_[line + 1] - 1 : length_;
+    }
+
+    /**
+     * @brief Line holding a byte offset, in O(log lines)
+     * @throws std::out_of_range if offset > the input length
+     */
+    std::size_t line_of(std::size_t offset) const {
+        if (offset > length_) {
+            throw std::out_of_range("Offset out of range");
+        }
+        return static_cast<std::size_t>(std::upper_bound(starts_.begin(), starts_.end(), offset) - starts_.begin()) - 1;
+    }
+
+    /**
+     * @brief Line and column of a byte offset
+     * @throws std::out_of_range if offset > the input length
+     *
+     * An offset inside a multi-byte character gives the column of that character. The input
+     * length is a valid offset: the position just after the last character. Characters are
+     * decoded as by make_char_range(), so each byte of ill-formed input is a column of its own.
+     */
+    LinePosition position(std::size_t offset) const {
+        LinePosition result;
+        result.line = line_of(offset);
+        std::size_t start = starts_[result.line];
+        if (result.line == 0) {
+            start = std::min(bom_size(), offset);
+        }
+        result.column = details::count_columns(data_, start, offset, length_);
+        return result;
+    }
+
+private:
+    const char* data_;
+    std::size_t length_;
+    std::vector<std::size_t> starts_;   ///< Byte offset of the start of each line
+
+    std::size_t bom_size() const {
+        bool bom = length_ >= 3 && static_cast<unsigned char>(data_[0]) == 0xEF &&
+                   static_cast<unsigned char>(data_[1]) == 0xBB && static_cast<unsigned char>(data_[2]) == 0xBF;
+        return bom ? 3 : 0;
+    }
+
+    void build() {
+        starts_.push_back(0);
+        std::size_t pos = 0;
+#if defined(U8SCAN_HAS_SSE2)
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; pos + 32 <= length_; pos += 32) {
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data_ + pos));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data_ + pos + 16));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(first, newline))) |
+                            (static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(second, newline))) << 16);
+            for (; mask != 0; mask &= mask - 1) {
+                starts_.push_back(pos + details::lowest_bit_index(mask) + 1);
+            }
+        }
+#endif
+        for (; pos < length_; ++pos) {
+            if (data_[pos] == '\n') {
+                starts_.push_back(pos + 1);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Converts an ASCII character to lowercase.
+ * @param info The character information.
+ * @return The lowercase version of the character if it's an ASCII letter (A-Z), otherwise returns the original codepoint.
+ * 
+ * This function only transforms ASCII uppercase letters (A-Z) to lowercase.
+ * Non-ASCII characters and non-uppercase ASCII characters are returned unchanged.
+ */
+inline uint32_t to_lower_ascii(const CharInfo& info) {
+    if (info.is_ascii && info.codepoint >= 'A' && info.codepoint <= 'Z') {
+        return info.codepoint + ('a' - 'A');
+    }
+    return info.codepoint;
+}
+
+/**
+ * @brief Converts an ASCII character to uppercase.
+ * @param info The character information.
+ * @return The uppercase version of the character if it's an ASCII letter (a-z), otherwise returns the original codepoint.
+ * 
+ * This function only transforms ASCII lowercase letters (a-z) to uppercase.
+ * Non-ASCII characters and non-lowercase ASCII characters are returned unchanged.
+ */
+inline uint32_t to_upper_ascii(const CharInfo& info) {
+    if (info.is_ascii && info.codepoint >= 'a' && info.codepoint <= 'z') {
+        return info.codepoint - ('a' - 'A');
+    }
+    return info.codepoint;
+}
+
+/**
+ * @brief Converts a Unicode codepoint to its UTF-8 string representation.
+ * @param info The character information containing the codepoint.
+ * @return The UTF-8 string representation of the codepoint.
+ * 
+ * This function converts any Unicode codepoint to its proper UTF-8 byte sequence.
+ * For ASCII characters (< 0x80), it returns a single-byte string.
+ * For non-ASCII characters, it returns the proper multi-byte UTF-8 sequence.
+ */
+inline std::string to_string(const CharInfo& info) {
+    char buffer[4];
+    std::size_t count = details::encode_utf8(info.codepoint, buffer);
+    return std::string(buffer, count);
+}
+
+/**
+ * @brief Converts a character to lowercase and returns as a UTF-8 string.
+ * @param info The character information.
+ * @return The lowercase version as a UTF-8 string.
  * 
- * Note: Plain text symbols like © ® ™ are NOT considered emoji unless they appear with 
- * emoji variation selectors (U+FE0F). This function only detects the base emoji characters.
+ * For ASCII characters, this function converts uppercase letters to lowercase
+ * and returns other ASCII characters unchanged as single-character strings.
+ * For non-ASCII characters, it returns the original character as a UTF-8 string.
+ */
+inline std::string to_lower_ascii_str(const CharInfo& info) {
+    if (info.is_ascii) {
+        char c = static_cast<char>(to_lower_ascii(info));
+        return std::string(1, c);
+    } else {
+        return to_string(info);
+    }
+}
+
+/**
+ * @brief Converts a character to uppercase and returns as a UTF-8 string.
+ * @param info The character information.
+ * @return The uppercase version as a UTF-8 string.
  * 
+ * For ASCII characters, this function converts lowercase letters to uppercase
+ * and returns other ASCII characters unchanged as single-character strings.
+ * For non-ASCII characters, it returns the original character as a UTF-8 string.
+ */
+inline std::string to_upper_ascii_str(const CharInfo& info) {
+    if (info.is_ascii) {
+        char c = static_cast<char>(to_upper_ascii(info));
+        return std::string(1, c);
+    } else {
+        return to_string(info);
+    }
+}
+
+namespace details {
+
+/**
+ * @brief Copy len bytes from src to dst, flipping the case bit of bytes in [first, last]
+ *
+ * src and dst may be the same buffer. Bytes of multi-byte UTF-8 sequences are all >= 0x80,
+ * so they never fall into an ASCII letter range and pass through unchanged.
+ */
+inline void convert_ascii_case(const char* src, char* dst, std::size_t len, char first, char last) {
+    std::size_t pos = 0;
+#if defined(U8SCAN_HAS_SSE2)
+    const __m128i range_first = _mm_set1_epi8(first);
+    const __m128i range_span = _mm_set1_epi8(static_cast<char>(last - first));
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+        __m128i offset = _mm_sub_epi8(v, range_first);
+        __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(offset, range_span), offset);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pos), _mm_xor_si128(v, _mm_and_si128(in_range, case_bit)));
+    }
+#endif
+    for (; pos < len; ++pos) {
+        char c = src[pos];
+        dst[pos] = (c >= first && c <= last) ? static_cast<char>(c ^ 0x20) : c;
+    }
+}
+
+} // namespace details
+
+/**
+ * @brief Converts all ASCII letters of a string to lowercase in place.
+ * @param str The string to convert.
+ * @return Reference to str.
+ *
+ * The whole buffer is processed 16 bytes at a time; non-ASCII characters and a BOM are left
+ * untouched, so the result has the same length and UTF-8 structure as the input.
+ */
+inline std::string& to_lower_ascii(std::string& str) {
+    if (!str.empty()) {
+        details::convert_ascii_case(&str[0], &str[0], str.length(), 'A', 'Z');
+    }
+    return str;
+}
+
+/**
+ * @brief Converts all ASCII letters of a string to uppercase in place.
+ * @param str The string to convert.
+ * @return Reference to str.
+ */
+inline std::string& to_upper_ascii(std::string& str) {
+    if (!str.empty()) {
+        details::convert_ascii_case(&str[0], &str[0], str.length(), 'a', 'z');
+    }
+    return str;
+}
+
+/**
+ * @brief Returns a copy of a string with all ASCII letters converted to lowercase.
+ * @param input The string to convert.
+ * @return The converted string, non-ASCII characters unchanged.
+ *
+ * @code
+ * std::string lower = u8scan::to_lower_ascii_str(u8"HELLO Wörld 世界");  // u8"hello wörld 世界"
+ * @endcode
+ */
+inline std::string to_lower_ascii_str(const std::string& input) {
+    std::string result(input.length(), '\0');
+    if (!input.empty()) {
+        details::convert_ascii_case(input.data(), &result[0], input.length(), 'A', 'Z');
+    }
+    return result;
+}
+
+/**
+ * @brief Returns a copy of a string with all ASCII letters converted to uppercase.
+ * @param input The string to convert.
+ * @return The converted string, non-ASCII characters unchanged.
+ */
+inline std::string to_upper_ascii_str(const std::string& input) {
+    std::string result(input.length(), '\0');
+    if (!input.empty()) {
+        details::convert_ascii_case(input.data(), &result[0], input.length(), 'a', 'z');
+    }
+    return result;
+}
+
+/**
+ * @brief Simple Unicode lowercase mapping of a code point.
+ * @param cp The code point.
+ * @return The Simple_Lowercase_Mapping of cp, or cp itself if it has none.
+ *
+ * Mappings come from the generated two-stage tables in u8scan_tables.h.
+ */
+inline uint32_t simple_lowercase(uint32_t cp) {
+    return static_cast<uint32_t>(static_cast<int32_t>(cp) + details::ucd::case_deltas(details::ucd::case_class(cp)).lower);
+}
+
+/**
+ * @brief Simple Unicode uppercase mapping of a code point.
+ * @param cp The code point.
+ * @return The Simple_Uppercase_Mapping of cp, or cp itself if it has none.
+ */
+inline uint32_t simple_uppercase(uint32_t cp) {
+    return static_cast<uint32_t>(static_cast<int32_t>(cp) + details::ucd::case_deltas(details::ucd::case_class(cp)).upper);
+}
+
+/**
+ * @brief Converts a character to lowercase using the Unicode simple case mapping.
+ * @param info The character information.
+ * @return The lowercase codepoint, or the original codepoint if the character has no mapping.
+ *
+ * Unlike to_lower_ascii() this covers all scripts with case (Latin, Greek, Cyrillic, Armenian, ...).
+ * Invalid UTF-8 bytes and bytes read in ASCII mode are only mapped if they are A-Z.
+ */
+inline uint32_t to_lower(const CharInfo& info) {
+    if (info.is_ascii || !info.is_valid_utf8) {
+        return to_lower_ascii(info);
+    }
+    return simple_lowercase(info.codepoint);
+}
+
+/**
+ * @brief Converts a character to uppercase using the Unicode simple case mapping.
+ * @param info The character information.
+ * @return The uppercase codepoint, or the original codepoint if the character has no mapping.
+ */
+inline uint32_t to_upper(const CharInfo& info) {
+    if (info.is_ascii || !info.is_valid_utf8) {
+        return to_upper_ascii(info);
+    }
+    return simple_uppercase(info.codepoint);
+}
+
+namespace details {
+
+/**
+ * @brief Applies a simple case mapping to a whole string
+ *
+ * ASCII runs are found and converted 16 bytes at a time; other characters are decoded and
+ * looked up in the case tables. Ill-formed sequences, including overlong forms and encoded
+ * surrogates, are copied unchanged.
+ */
+template<typename Mapping>
+inline std::string convert_case(const std::string& input, char first, char last, Mapping mapping) {
+    std::string result;
+    result.reserve(input.length());
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t pos = 0;
+
+    while (pos < length) {
+        std::size_t ascii_end = skip_ascii(data, pos, length);
+        if (ascii_end > pos) {
+            std::size_t offset = result.length();
+            result.resize(offset + (ascii_end - pos));
+            convert_ascii_case(data + pos, &result[offset], ascii_end - pos, first, last);
+            pos = ascii_end;
+            continue;
+        }
+        bool valid;
+        std::size_t count = utf8_sequence_length(data, pos, length, valid);
+        uint32_t codepoint = valid ? decode_utf8(data + pos, count) : 0;
+        uint32_t mapped = valid ? mapping(codepoint) : codepoint;
+        if (mapped == codepoint) {
+            result.append(data + pos, count);
+        } else {
+            char buffer[4];
+            result.append(buffer, encode_utf8(mapped, buffer));
+        }
+        pos += count;
+    }
+    return result;
+}
+
+} // namespace details
+
+/**
+ * @brief Returns a copy of a UTF-8 string converted to lowercase with the Unicode simple case mapping.
+ * @param input The string to convert.
+ * @return The lowercase string.
+ *
+ * The output is reserved up front and ASCII text is converted 16 bytes at a time. Simple case
+ * mappings are one-to-one, so the number of characters never changes (the byte length can, e.g.
+ * U+023A is 2 bytes and its lowercase U+2C65 is 3 bytes).
+ *
+ * @code
+ * std::string lower = u8scan::to_lower_str(u8"ÀÉÎ ΣΑΣ Привет");  // u8"àéî σασ привет"
+ * @endcode
+ */
+inline std::string to_lower_str(const std::string& input) {
+    return details::convert_case(input, 'A', 'Z', simple_lowercase);
+}
+
+/**
+ * @brief Returns a copy of a UTF-8 string converted to uppercase with the Unicode simple case mapping.
+ * @param input The string to convert.
+ * @return The uppercase string.
+ */
+inline std::string to_upper_str(const std::string& input) {
+    return details::convert_case(input, 'a', 'z', simple_uppercase);
+}
+
+/**
+ * @brief Simple Unicode case folding of a code point.
+ * @param cp The code point.
+ * @return The Simple_Case_Folding of cp (statuses C and S of CaseFolding.txt), or cp itself.
+ */
+inline uint32_t simple_casefold(uint32_t cp) {
+    return static_cast<uint32_t>(static_cast<int32_t>(cp) + details::ucd::case_deltas(details::ucd::case_class(cp)).fold);
+}
+
+/**
+ * @brief Full Unicode case folding of a code point.
+ * @param cp The code point.
+ * @param out Receives 1 to 3 folded code points.
+ * @return Number of code points written to out.
+ *
+ * Uses statuses C and F of CaseFolding.txt, e.g. U+00DF (ß) folds to "ss".
+ */
+inline std::size_t casefold(uint32_t cp, uint32_t* out) {
+    const details::ucd::CaseDeltas& deltas = details::ucd::case_deltas(details::ucd::case_class(cp));
+    if (deltas.full_fold) {
+        const details::ucd::FullCaseFolding* full = details::ucd::full_case_folding(cp);
+        std::size_t count = 0;
+        for (; count < 3 && full->folded[count] != 0; ++count) {
+            out[count] = full->folded[count];
+        }
+        return count;
+    }
+    out[0] = static_cast<uint32_t>(static_cast<int32_t>(cp) + deltas.fold);
+    return 1;
+}
+
+namespace details {
+
+/**
+ * @brief Streams the full case folding of a string one code point at a time
+ *
+ * A leading BOM is skipped. Each byte of an ill-formed sequence (including overlong forms and
+ * encoded surrogates) is returned as 0x110000 + byte, so it only matches the same invalid byte
+ * and sorts after all code points.
+ */
+class CasefoldReader {
+private:
+    const std::string& input_;
+    std::size_t pos_;
+    uint32_t pending_[3];
+    std::size_t pending_pos_;
+    std::size_t pending_count_;
+
+public:
+    explicit CasefoldReader(const std::string& input)
+        : input_(input), pos_(detect_bom(input).found ? 3 : 0), pending_pos_(0), pending_count_(0) {}
+
+    std::size_t position() const { return pos_; }
+    bool has_pending() const { return pending_pos_ < pending_count_; }
+    void skip(std::size_t bytes) { pos_ += bytes; }
+
+    bool next(uint32_t& cp) {
+        if (pending_pos_ < pending_count_) {
+            cp = pending_[pending_pos_++];
+            return true;
+        }
+        if (pos_ >= input_.length()) {
+            return false;
+        }
+        unsigned char byte = static_cast<unsigned char>(input_[pos_]);
+        if (byte < 0x80) {
+            cp = (byte >= 'A' && byte <= 'Z') ? byte + 0x20u : byte;
+            ++pos_;
+            return true;
+        }
+        bool valid;
+        std::size_t count = utf8_sequence_length(input_.data(), pos_, input_.length(), valid);
+        if (!valid) {
+            cp = 0x110000u + byte;
+            ++pos_;
+            return true;
+        }
+        pending_count_ = casefold(decode_utf8(input_.data() + pos_, count), pending_);
+        pos_ += count;
+        pending_pos_ = 1;
+        cp = pending_[0];
+        return true;
+    }
+};
+
+#if defined(U8SCAN_HAS_SSE2)
+/**
+ * @brief Lowercase the ASCII letters of 16 bytes
+ */
+inline __m128i fold_ascii_block(__m128i v) {
+    __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8('A'));
+    __m128i is_upper = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(25)), offset);
+    return _mm_or_si128(v, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+}
+#endif
+
+} // namespace details
+
+/**
+ * @brief Compare two UTF-8 strings ignoring case, using full Unicode case folding.
+ * @param a First string.
+ * @param b Second string.
+ * @return Negative if a sorts before b, 0 if they are equal ignoring case, positive otherwise.
+ *
+ * Both strings are folded on the fly without allocating; the order is that of the folded code
+ * points. While both sides are ASCII they are folded and compared 16 bytes per step. A leading
+ * BOM is ignored and invalid bytes only match identical invalid bytes.
+ *
+ * @code
+ * assert(u8scan::casefold_compare(u8"Straße", u8"STRASSE") == 0);
+ * assert(u8scan::casefold_compare("apple", "Banana") < 0);
+ * @endcode
+ */
+inline int casefold_compare(const std::string& a, const std::string& b) {
+    details::CasefoldReader reader_a(a);
+    details::CasefoldReader reader_b(b);
+    for (;;) {
+#if defined(U8SCAN_HAS_SSE2)
+        while (!reader_a.has_pending() && !reader_b.has_pending() &&
+               reader_a.position() + 16 <= a.length() && reader_b.position() + 16 <= b.length()) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + reader_a.position()));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + reader_b.position()));
+            if (_mm_movemask_epi8(_mm_or_si128(va, vb)) != 0) {
+                break;
+            }
+            __m128i fa = details::fold_ascii_block(va);
+            __m128i fb = details::fold_ascii_block(vb);
+            uint32_t diff = static_cast<uint32_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(fa, fb))) & 0xFFFFu;
+            if (diff != 0) {
+                // Only ASCII, so the first differing byte decides
+                std::size_t index = details::lowest_bit_index(diff);
+                unsigned char ca = static_cast<unsigned char>(a[reader_a.position() + index]);
+                unsigned char cb = static_cast<unsigned char>(b[reader_b.position() + index]);
+                ca = static_cast<unsigned char>((ca >= 'A' && ca <= 'Z') ? ca + 0x20 : ca);
+                cb = static_cast<unsigned char>((cb >= 'A' && cb <= 'Z') ? cb + 0x20 : cb);
+                return ca < cb ? -1 : 1;
+            }
+            reader_a.skip(16);
+            reader_b.skip(16);
+        }
+#endif
+        uint32_t cp_a;
+        uint32_t cp_b;
+        bool has_a = reader_a.next(cp_a);
+        bool has_b = reader_b.next(cp_b);
+        if (!has_a || !has_b) {
+            return has_a ? 1 : (has_b ? -1 : 0);
+        }
+        if (cp_a != cp_b) {
+            return cp_a < cp_b ? -1 : 1;
+        }
+    }
+}
+
+/**
+ * @brief Check whether two UTF-8 strings are equal ignoring case (full Unicode case folding).
+ */
+inline bool casefold_equal(const std::string& a, const std::string& b) {
+    return casefold_compare(a, b) == 0;
+}
+
+/**
+ * @brief Hash of the case folded form of a UTF-8 string.
+ * @param input The string to hash.
+ * @return FNV-1a hash of the folded code points; strings that are casefold_equal() hash equally.
+ *
+ * No folded copy is built; ASCII is folded 16 bytes at a time.
+ */
+inline std::size_t casefold_hash(const std::string& input) {
+    uint64_t hash = 14695981039346656037ULL;
+    const uint64_t prime = 1099511628211ULL;
+    details::CasefoldReader reader(input);
+    for (;;) {
+#if defined(U8SCAN_HAS_SSE2)
+        while (!reader.has_pending() && reader.position() + 16 <= input.length()) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + reader.position()));
+            if (_mm_movemask_epi8(v) != 0) {
+                break;
+            }
+            unsigned char folded[16];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(folded), details::fold_ascii_block(v));
+            for (int i = 0; i < 16; ++i) {
+                hash = (hash ^ folded[i]) * prime;
+            }
+            reader.skip(16);
+        }
+#endif
+        uint32_t cp;
+        if (!reader.next(cp)) {
+            break;
+        }
+        hash = (hash ^ cp) * prime;
+    }
+    return static_cast<std::size_t>(hash ^ (hash >> 32));
+}
+
+/**
+ * @brief Returns the full case folding of a UTF-8 string.
+ * @param input The string to fold.
+ * @return The folded string, e.g. for keys in containers that do not support custom comparison.
+ */
+inline std::string casefold_str(const std::string& input) {
+    std::string result;
+    result.reserve(input.length());
+    details::CasefoldReader reader(input);
+    uint32_t cp;
+    while (reader.next(cp)) {
+        if (cp >= 0x110000u) {
+            result += static_cast<char>(cp - 0x110000u);
+        } else {
+            char buffer[4];
+            result.append(buffer, details::encode_utf8(cp, buffer));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Case-insensitive hash functor for unordered containers, see casefold_hash()
+ */
+struct CasefoldHash {
+    std::size_t operator()(const std::string& s) const { return casefold_hash(s); }
+};
+
+/**
+ * @brief Case-insensitive equality functor for unordered containers, see casefold_equal()
+ *
+ * @code
+ * std::unordered_set<std::string, u8scan::CasefoldHash, u8scan::CasefoldEqual> users;
+ * users.insert(u8"Jürgen");
+ * assert(users.count(u8"JÜRGEN") == 1);
+ * @endcode
+ */
+struct CasefoldEqual {
+    bool operator()(const std::string& a, const std::string& b) const { return casefold_equal(a, b); }
+};
+
+/**
+ * @brief Unicode normalization forms
+ */
+enum class NormalizationForm {
+    NFC,    ///< Canonical decomposition followed by canonical composition
+    NFD,    ///< Canonical decomposition
+    NFKC,   ///< Compatibility decomposition followed by canonical composition
+    NFKD    ///< Compatibility decomposition
+};
+
+/**
+ * @brief Result of a normalization quick check
+ */
+enum class QuickCheckResult {
+    YES,    ///< The string is normalized
+    NO,     ///< The string is not normalized
+    MAYBE   ///< The string has to be normalized to find out
+};
+
+namespace details {
+
+/**
+ * @brief Quick check flags for which a code point is not allowed in a normalization form
+ */
+inline uint8_t quick_check_no_flags(NormalizationForm form) {
+    switch (form) {
+        case NormalizationForm::NFC: return ucd::quick_check_nfc_no;
+        case NormalizationForm::NFD: return ucd::quick_check_nfd_no;
+        case NormalizationForm::NFKC: return ucd::quick_check_nfkc_no;
+        default: return ucd::quick_check_nfkd_no;
+    }
+}
+
+/**
+ * @brief Quick check flags for which a code point may combine with the preceding one
+ */
+inline uint8_t quick_check_maybe_flags(NormalizationForm form) {
+    switch (form) {
+        case NormalizationForm::NFC: return ucd::quick_check_nfc_maybe;
+        case NormalizationForm::NFKC: return ucd::quick_check_nfkc_maybe;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Quick check of data[0, length) per UAX #15
+ * @param stop_on_maybe Return at the first MAYBE code point instead of checking the rest
+ * @param boundary Set to the start of the code point from which normalization has to start: the last
+ *        stable code point (canonical combining class 0, quick check YES) before the first code point
+ *        that is not YES, or length if the result is YES
+ *
+ * Invalid bytes are treated as stable and are never changed by normalization.
+ */
+inline QuickCheckResult quick_check_prefix(const char* data, std::size_t length, NormalizationForm form,
+                                           bool stop_on_maybe, std::size_t& boundary) {
+    const uint8_t no_flags = quick_check_no_flags(form);
+    const uint8_t maybe_flags = quick_check_maybe_flags(form);
+    QuickCheckResult result = QuickCheckResult::YES;
+    std::size_t stable = 0;
+    uint8_t last_ccc = 0;
+    std::size_t pos = 0;
+    while (pos < length) {
+        std::size_t next = skip_ascii(data, pos, length);
+        if (next != pos) {
+            stable = next - 1;
+            last_ccc = 0;
+            pos = next;
+            continue;
+        }
+        bool valid;
+        std::size_t count = utf8_sequence_length(data, pos, length, valid);
+        if (!valid) {
+            stable = pos;
+            last_ccc = 0;
+            pos += count;
+            continue;
+        }
+        uint32_t cp = decode_utf8(data + pos, count);
+        uint8_t ccc = ucd::combining_class(cp);
+        uint8_t flags = ucd::quick_check(cp);
+        if ((flags & no_flags) != 0 || (ccc != 0 && last_ccc > ccc)) {
+            boundary = stable;
+            return QuickCheckResult::NO;
+        }
+        if ((flags & maybe_flags) != 0) {
+            if (stop_on_maybe) {
+                boundary = stable;
+                return QuickCheckResult::MAYBE;
+            }
+            result = QuickCheckResult::MAYBE;
+        } else if (ccc == 0) {
+            stable = pos;
+        }
+        last_ccc = ccc;
+        pos += count;
+    }
+    boundary = result == QuickCheckResult::YES ? length : stable;
+    return result;
+}
+
+/**
+ * @brief Start of the last stable code point in data[pos, length), or stable if there is none
+ * @param pos Where to resume scanning; set to where the scan stopped, so that a caller adding
+ *            data at the end never rescans what it has seen
+ * @param stable Result of the previous scan, 0 at first
+ *
+ * Text before this position normalizes independently of anything that follows. A sequence
+ * truncated by the end of the data is not considered, it may be completed by more input.
+ */
+inline std::size_t last_stable_boundary(const char* data, std::size_t& pos, std::size_t length,
+                                        NormalizationForm form, std::size_t stable) {
+    const uint8_t unstable_flags = static_cast<uint8_t>(quick_check_no_flags(form) | quick_check_maybe_flags(form));
+    while (pos < length) {
+        std::size_t next = skip_ascii(data, pos, length);
+        if (next != pos) {
+            stable = next - 1;
+            pos = next;
+            continue;
+        }
+        bool valid;
+        std::size_t count = utf8_sequence_length(data, pos, length, valid);
+        if (!valid) {
+            if (pos + count == length) {
+                break;
+            }
+            stable = pos;
+        } else {
+            uint32_t cp = decode_utf8(data + pos, count);
+            if (ucd::combining_class(cp) == 0 && (ucd::quick_check(cp) & unstable_flags) == 0) {
+                stable = pos;
+            }
+        }
+        pos += count;
+    }
+    return stable;
+}
+
+/**
+ * @brief Decomposes, reorders and composes code points one normalization segment at a time
+ *
+ * A segment is a starter followed by the non-starters that belong to it; it is written out as
+ * soon as the next segment starts, so the buffer only ever holds a few code points.
+ */
+class NormalizationBuffer {
+private:
+    static const uint32_t hangul_s_base = 0xAC00;
+    static const uint32_t hangul_l_base = 0x1100;
+    static const uint32_t hangul_v_base = 0x1161;
+    static const uint32_t hangul_t_base = 0x11A7;
+    static const uint32_t hangul_l_count = 19;
+    static const uint32_t hangul_v_count = 21;
+    static const uint32_t hangul_t_count = 28;
+    static const uint32_t hangul_n_count = hangul_v_count * hangul_t_count;
+    static const uint32_t hangul_s_count = hangul_l_count * hangul_n_count;
+
+    struct Entry {
+        uint32_t cp;
+        uint8_t ccc;
+    };
+
+    std::vector<Entry> entries_;
+    bool compatibility_;
+    bool compose_;
+
+    static uint32_t compose(uint32_t first, uint32_t second) {
+        if (first - hangul_l_base < hangul_l_count && second - hangul_v_base < hangul_v_count) {
+            return hangul_s_base + ((first - hangul_l_base) * hangul_v_count + (second - hangul_v_base)) * hangul_t_count;
+        }
+        if (first - hangul_s_base < hangul_s_count && (first - hangul_s_base) % hangul_t_count == 0 &&
+            second - hangul_t_base - 1 < hangul_t_count - 1) {
+            return first + (second - hangul_t_base);
+        }
+        return ucd::compose_pair(first, second);
+    }
+
+    void push(uint32_t cp, std::string& out) {
+        uint8_t ccc = ucd::combining_class(cp);
+        if (ccc == 0) {
+            if (!compose_ || (ucd::quick_check(cp) & ucd::quick_check_nfc_maybe) == 0) {
+                flush(out);
+            }
+            Entry entry = {cp, ccc};
+            entries_.push_back(entry);
+            return;
+        }
+        // Canonical ordering: stable insertion among the trailing non-starters
+        std::size_t i = entries_.size();
+        while (i > 0 && entries_[i - 1].ccc > ccc) {
+            --i;
+        }
+        Entry entry = {cp, ccc};
+        entries_.insert(entries_.begin() + static_cast<std::ptrdiff_t>(i), entry);
+    }
+
+    void compose_entries() {
+        std::size_t starter = 0;
+        bool has_starter = entries_[0].ccc == 0;
+        unsigned last_ccc = has_starter ? 0 : 256;
+        std::size_t kept = 1;
+        for (std::size_t i = 1; i < entries_.size(); ++i) {
+            Entry entry = entries_[i];
+            if (has_starter && (last_ccc < entry.ccc || last_ccc == 0)) {
+                uint32_t composite = compose(entries_[starter].cp, entry.cp);
+                if (composite != 0) {
+                    entries_[starter].cp = composite;
+                    continue;
+                }
+            }
+            if (entry.ccc == 0) {
+                starter = kept;
+                has_starter = true;
+            }
+            last_ccc = entry.ccc;
+            entries_[kept++] = entry;
+        }
+        entries_.resize(kept);
+    }
+
+public:
+    explicit NormalizationBuffer(NormalizationForm form)
+        : compatibility_(form == NormalizationForm::NFKC || form == NormalizationForm::NFKD),
+          compose_(form == NormalizationForm::NFC || form == NormalizationForm::NFKC) {}
+
+    /**
+     * @brief Adds the full decomposition of a code point
+     */
+    void decompose(uint32_t cp, std::string& out) {
+        if (cp - hangul_s_base < hangul_s_count) {
+            uint32_t index = cp - hangul_s_base;
+            push(hangul_l_base + index / hangul_n_count, out);
+            push(hangul_v_base + (index % hangul_n_count) / hangul_t_count, out);
+            if (index % hangul_t_count != 0) {
+                push(hangul_t_base + index % hangul_t_count, out);
+            }
+            return;
+        }
+        unsigned index = ucd::decomposition_index(cp);
+        if (index != 0) {
+            const ucd::Decomposition& mapping = ucd::decompositions(index);
+            if (!mapping.compatibility || compatibility_) {
+                const uint32_t* targets = ucd::decomposition_data() + mapping.offset;
+                for (uint8_t i = 0; i < mapping.length; ++i) {
+                    decompose(targets[i], out);
+                }
+                return;
+            }
+        }
+        push(cp, out);
+    }
+
+    /**
+     * @brief Writes the pending segment to out
+     */
+    void flush(std::string& out) {
+        if (entries_.empty()) {
+            return;
+        }
+        if (compose_) {
+            compose_entries();
+        }
+        for (std::size_t i = 0; i < entries_.size(); ++i) {
+            char buffer[4];
+            out.append(buffer, encode_utf8(entries_[i].cp, buffer));
+        }
+        entries_.clear();
+    }
+
+    /**
+     * @brief Normalizes data[pos, end) and appends the result to out
+     *
+     * The text must start at a stable code point or at the start of the input, and end at one or at
+     * the end of the input. Invalid bytes are copied unchanged.
+     */
+    void normalize(const char* data, std::size_t pos, std::size_t end, std::string& out) {
+        while (pos < end) {
+            std::size_t next = skip_ascii(data, pos, end);
+            if (next != pos) {
+                // ASCII never changes, only the last character of a run can compose with what follows
+                flush(out);
+                out.append(data + pos, next - pos - 1);
+                Entry entry = {static_cast<unsigned char>(data[next - 1]), 0};
+                entries_.push_back(entry);
+                pos = next;
+                continue;
+            }
+            bool valid;
+            std::size_t count = utf8_sequence_length(data, pos, end, valid);
+            if (valid) {
+                decompose(decode_utf8(data + pos, count), out);
+            } else {
+                flush(out);
+                out.append(data + pos, count);
+            }
+            pos += count;
+        }
+        flush(out);
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief Quick check whether a UTF-8 string is in a normalization form
+ * @param input The string to check
+ * @param form The normalization form
+ * @return YES or NO when the Quick_Check properties decide, MAYBE when only normalizing can tell
+ *
+ * ASCII is skipped 16 bytes at a time; no memory is allocated.
+ */
+inline QuickCheckResult quick_check(const std::string& input, NormalizationForm form = NormalizationForm::NFC) {
+    std::size_t boundary;
+    return details::quick_check_prefix(input.data(), input.length(), form, false, boundary);
+}
+
+/**
+ * @brief Normalize a UTF-8 string
+ * @param input The string to normalize
+ * @param out Buffer receiving the normalized string when input is not normalized (must not be input)
+ * @param form The normalization form
+ * @return input itself if it is already normalized, otherwise out
+ *
+ * The quick check runs first: when it passes, input is returned without copying or allocating.
+ * Otherwise the text before the first code point that fails the check is copied as is and only
+ * the rest is decomposed, reordered and (for NFC and NFKC) recomposed. Invalid UTF-8 bytes are
+ * copied unchanged and block composition across them.
+ *
+ * @code
+ * std::string buffer;
+ * const std::string& key = u8scan::normalize(name, buffer);   // u8"é" -> u8"é"
+ * @endcode
+ */
+inline const std::string& normalize(const std::string& input, std::string& out,
+                                    NormalizationForm form = NormalizationForm::NFC) {
+    std::size_t boundary;
+    QuickCheckResult check = details::quick_check_prefix(input.data(), input.length(), form, true, boundary);
+    if (check == QuickCheckResult::YES) {
+        return input;
+    }
+
+    out.clear();
+    out.reserve(input.length() + input.length() / 8);
+    out.append(input, 0, boundary);
+    details::NormalizationBuffer buffer(form);
+    buffer.normalize(input.data(), boundary, input.length(), out);
+    if (check == QuickCheckResult::MAYBE && out == input) {
+        return input;
+    }
+    return out;
+}
+
+/**
+ * @brief Normalized copy of a UTF-8 string
+ */
+inline std::string normalize(const std::string& input, NormalizationForm form = NormalizationForm::NFC) {
+    std::string buffer;
+    if (&normalize(input, buffer, form) == &input) {
+        return input;
+    }
+    return buffer;
+}
+
+/**
+ * @brief Check whether a UTF-8 string is in a normalization form
+ *
+ * Only normalizes when the quick check answers MAYBE.
+ */
+inline bool is_normalized(const std::string& input, NormalizationForm form = NormalizationForm::NFC) {
+    std::string buffer;
+    return &normalize(input, buffer, form) == &input;
+}
+
+/**
+ * @brief Incremental normalization of text that arrives in chunks
+ *
+ * Chunks may split the text anywhere, even inside a UTF-8 sequence. Output is produced up to the
+ * last stable code point of the text received so far; only the text after it is kept back, so
+ * memory use does not grow with the input size. The exception is a run of code points without a
+ * stable one, such as a long run of combining marks, which is kept back until it ends since
+ * canonical ordering needs all of it.
+ *
+ * @code
+ * u8scan::Normalizer normalizer(u8scan::NormalizationForm::NFC);
+ * std::string out;
+ * while (read_chunk(file, chunk)) {
+ *     normalizer.append(chunk, out);
+ *     write(out);
+ *     out.clear();
+ * }
+ * normalizer.finish(out);
+ * write(out);
+ * @endcode
+ */
+class Normalizer {
+private:
+    NormalizationForm form_;
+    std::string pending_;
+    std::size_t scanned_;       ///< Bytes of pending_ already searched for a stable code point
+    std::size_t stable_;        ///< Start of the last stable code point found in pending_, or 0
+    details::NormalizationBuffer buffer_;
+
+    void normalize_pending(std::size_t end, std::string& out) {
+        std::size_t boundary;
+        QuickCheckResult check = details::quick_check_prefix(pending_.data(), end, form_, true, boundary);
+        out.append(pending_, 0, boundary);
+        if (check != QuickCheckResult::YES) {
+            buffer_.normalize(pending_.data(), boundary, end, out);
+        }
+        pending_.erase(0, end);
+        scanned_ = scanned_ > end ? scanned_ - end : 0;
+        stable_ = 0;
+    }
+
+public:
+    explicit Normalizer(NormalizationForm form = NormalizationForm::NFC)
+        : form_(form), scanned_(0), stable_(0), buffer_(form) {}
+
+    NormalizationForm form() const { return form_; }
+
+    /**
+     * @brief Add the next chunk of text and append all output that is final to out
+     *
+     * Only the new text is searched for a stable code point, so streaming is linear in the
+     * input size however small the chunks are.
+     */
+    void append(const std::string& chunk, std::string& out) {
+        pending_ += chunk;
+        stable_ = details::last_stable_boundary(pending_.data(), scanned_, pending_.length(), form_, stable_);
+        if (stable_ != 0) {
+            normalize_pending(stable_, out);
+        }
+    }
+
+    /**
+     * @brief Append the rest of the normalized text to out; the normalizer can then be reused
+     */
+    void finish(std::string& out) {
+        normalize_pending(pending_.length(), out);
+    }
+};
+
+/**
+ * @brief A text segment (grapheme cluster, word, ...) as a byte span of the input string
+ */
+struct Segment {
+    std::size_t start_pos;      ///< Starting position in the string
+    std::size_t byte_count;     ///< Number of bytes in the segment
+    std::size_t char_count;     ///< Number of characters (code points or invalid bytes) in the segment
+
+    Segment() : start_pos(0), byte_count(0), char_count(0) {}
+
+    std::size_t end_pos() const { return start_pos + byte_count; }
+};
+
+/**
+ * @brief Forward iterator over the segments of a string
+ * @tparam Segmenter Provides `static std::size_t next(const std::string& str, std::size_t pos, std::size_t end, std::size_t& char_count)`
+ *         returning the end of the segment that starts at pos
+ *
+ * Segments are found on demand and reference the string without copying.
+ */
+template<typename Segmenter>
+class SegmentIterator {
+private:
+    const std::string* str_;
+    std::size_t pos_;
+    std::size_t end_;
+    mutable Segment current_;
+    mutable bool cached_;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Segment;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Segment*;
+    using reference = const Segment&;
+
+    SegmentIterator(const std::string* str, std::size_t pos, std::size_t end)
+        : str_(str), pos_(pos), end_(end), cached_(false) {}
+
+    const Segment& operator*() const {
+        if (!cached_) {
+            current_.start_pos = pos_;
+            current_.char_count = 0;
+            current_.byte_count = Segmenter::next(*str_, pos_, end_, current_.char_count) - pos_;
+            cached_ = true;
+        }
+        return current_;
+    }
+
+    const Segment* operator->() const {
+        return &(operator*());
+    }
+
+    SegmentIterator& operator++() {
+        pos_ += operator*().byte_count;
+        cached_ = false;
+        return *this;
+    }
+
+    SegmentIterator operator++(int) {
+        SegmentIterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const SegmentIterator& other) const {
+        return str_ == other.str_ && pos_ == other.pos_;
+    }
+
+    bool operator!=(const SegmentIterator& other) const {
+        return !(*this == other);
+    }
+
+    std::size_t position() const { return pos_; }
+};
+
+/**
+ * @brief Range of the segments of a string, see SegmentIterator
+ */
+template<typename Segmenter>
+class SegmentRange {
+private:
+    const std::string* str_;
+    std::size_t start_pos_;
+    std::size_t end_pos_;
+
+public:
+    explicit SegmentRange(const std::string& str, bool skip_bom = true)
+        : str_(&str), start_pos_(skip_bom && details::detect_bom(str).found ? 3 : 0), end_pos_(str.length()) {}
+
+    SegmentIterator<Segmenter> begin() const {
+        return SegmentIterator<Segmenter>(str_, start_pos_, end_pos_);
+    }
+
+    SegmentIterator<Segmenter> end() const {
+        return SegmentIterator<Segmenter>(str_, end_pos_, end_pos_);
+    }
+
+    std::size_t size() const {
+        return static_cast<std::size_t>(std::distance(begin(), end()));
+    }
+
+    bool empty() const {
+        return start_pos_ >= end_pos_;
+    }
+};
+
+namespace details {
+
+/**
+ * @brief Grapheme_Cluster_Break of a character; invalid bytes are treated like U+FFFD
+ */
+inline uint8_t grapheme_class(const CharInfo& info) {
+    return info.is_valid_utf8 ? ucd::grapheme_break(info.codepoint) : ucd::grapheme_other;
+}
+
+/**
+ * @brief Whether UAX #29 rules GB3 to GB9b keep two adjacent characters in one grapheme cluster
+ *
+ * The context-dependent rules GB11 (emoji ZWJ sequences) and GB12/GB13 (flags) are applied by
+ * GraphemeSegmenter.
+ */
+inline bool grapheme_pair_joins(uint8_t before, uint8_t after) {
+    static_assert(ucd::grapheme_extended_pictographic == 14, "table below is indexed by grapheme_break() values");
+    const uint16_t lf = 1u << ucd::grapheme_lf;
+    const uint16_t controls = (1u << ucd::grapheme_cr) | lf | (1u << ucd::grapheme_control);
+    const uint16_t extenders = (1u << ucd::grapheme_extend) | (1u << ucd::grapheme_zwj) | (1u << ucd::grapheme_spacing_mark);
+    const uint16_t l = 1u << ucd::grapheme_l;
+    const uint16_t v = 1u << ucd::grapheme_v;
+    const uint16_t t = 1u << ucd::grapheme_t;
+    const uint16_t lv = 1u << ucd::grapheme_lv;
+    const uint16_t lvt = 1u << ucd::grapheme_lvt;
+    static const uint16_t joins[15] = {
+        extenders,                              // Other
+        lf,                                     // CR (GB3)
+        0,                                      // LF (GB4)
+        0,                                      // Control (GB4)
+        extenders,                              // Extend
+        extenders,                              // ZWJ
+        extenders,                              // Regional_Indicator
+        static_cast<uint16_t>(0x7FFF & ~controls), // Prepend (GB9b)
+        extenders,                              // SpacingMark
+        extenders | l | v | lv | lvt,           // L (GB6)
+        extenders | v | t,                      // V (GB7)
+        extenders | t,                          // T (GB8)
+        extenders | v | t,                      // LV (GB7)
+        extenders | t,                          // LVT (GB8)
+        extenders,                              // Extended_Pictographic
+    };
+    return (joins[before] >> after) & 1u;
+}
+
+/**
+ * @brief Finds extended grapheme cluster boundaries per UAX #29
+ */
+struct GraphemeSegmenter {
+    static std::size_t next(const std::string& str, std::size_t pos, std::size_t end, std::size_t& char_count) {
+        const char* data = str.data();
+        unsigned char first = static_cast<unsigned char>(data[pos]);
+        if (first < 0x80) {
+            // ASCII followed by ASCII: only CR LF forms a multi-character cluster
+            if (first == '\r' && pos + 1 < end && data[pos + 1] == '\n') {
+                char_count = 2;
+                return pos + 2;
+            }
+            if (pos + 1 >= end || static_cast<unsigned char>(data[pos + 1]) < 0x80 || first < 0x20 || first == 0x7F) {
+                char_count = 1;
+                return pos + 1;
+            }
+        }
+
+        CharIterator it(&str, pos);
+        uint8_t before = grapheme_class(*it);
+        bool pictographic = before == ucd::grapheme_extended_pictographic;  // ExtPict Extend* seen
+        bool pictographic_zwj = false;                                    // ExtPict Extend* ZWJ seen
+        std::size_t regional_indicators = before == ucd::grapheme_regional_indicator ? 1 : 0;
+        char_count = 1;
+        for (++it; it.position() < end; ++it) {
+            uint8_t after = grapheme_class(*it);
+            bool joins;
+            if (before == ucd::grapheme_zwj && after == ucd::grapheme_extended_pictographic) {
+                joins = pictographic_zwj;                                   // GB11
+            } else if (before == ucd::grapheme_regional_indicator && after == ucd::grapheme_regional_indicator) {
+                joins = regional_indicators % 2 == 1;                       // GB12, GB13
+            } else {
+                joins = grapheme_pair_joins(before, after);
+            }
+            if (!joins) {
+                break;
+            }
+            pictographic_zwj = pictographic && after == ucd::grapheme_zwj;
+            pictographic = after == ucd::grapheme_extended_pictographic || (pictographic && after == ucd::grapheme_extend);
+            regional_indicators = after == ucd::grapheme_regional_indicator ? regional_indicators + 1 : 0;
+            before = after;
+            ++char_count;
+        }
+        return it.position() < end ? it.position() : end;
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief Iterator over extended grapheme clusters (user-perceived characters)
+ */
+using GraphemeIterator = SegmentIterator<details::GraphemeSegmenter>;
+
+/**
+ * @brief Range of extended grapheme clusters
+ */
+using GraphemeRange = SegmentRange<details::GraphemeSegmenter>;
+
+/**
+ * @brief Range over the extended grapheme clusters of a UTF-8 string (UAX #29)
+ * @param input The string to segment
+ * @param skip_bom Skip a leading BOM
+ *
+ * A cluster is what users perceive as one character: a base with its combining marks, a Hangul
+ * syllable from jamo, a flag (pair of regional indicators) or an emoji ZWJ sequence with skin tone
+ * modifiers. Each Segment is a byte span of input, nothing is copied.
+ *
  * @code
- * auto range = u8scan::make_char_range("Hello 🌍 World! 🚀");
- * size_t emoji_count = std::count_if(range.begin(), range.end(), u8scan::predicates::is_emoji());
- * // emoji_count will be 2 (🌍 and 🚀)
+ * std::string text = u8"é🇩🇪👨‍👩‍👧";
+ * for (const auto& g : u8scan::graphemes(text)) {
+ *     std::cout << text.substr(g.start_pos, g.byte_count) << '\n';   // 3 clusters
+ * }
  * @endcode
  */
-inline std::function<bool(const CharInfo&)> is_emoji() {
-    return [](const CharInfo& info) {
-        uint32_t cp = info.codepoint;
-        
-        // Main emoji Unicode ranges based on Unicode Standard
-        // Reference: https://unicode.org/emoji/charts/full-emoji-list.html
-        
-        // Emoticons (U+1F600-U+1F64F)
-        if (cp >= 0x1F600 && cp <= 0x1F64F) return true;
-        
-        // Miscellaneous Symbols and Pictographs (U+1F300-U+1F5FF)
-        if (cp >= 0x1F300 && cp <= 0x1F5FF) return true;
-        
-        // Transport and Map Symbols (U+1F680-U+1F6FF)
-        if (cp >= 0x1F680 && cp <= 0x1F6FF) return true;
-        
-        // Supplemental Symbols and Pictographs (U+1F900-U+1F9FF)
-        if (cp >= 0x1F900 && cp <= 0x1F9FF) return true;
-        
-        // Symbols and Pictographs Extended-A (U+1FA70-U+1FAFF)
-        if (cp >= 0x1FA70 && cp <= 0x1FAFF) return true;
-        
-        // Regional Indicator Symbols (Flags) (U+1F1E6-U+1F1FF)
-        if (cp >= 0x1F1E6 && cp <= 0x1F1FF) return true;
-        
-        // Miscellaneous Symbols (some emoji) (U+2600-U+26FF)
-        // Common emoji in this range: ☀️ ⭐ ❤️ ⚡ ☔ ❄️ ⛄ ⚽ ⚾ ⛳ etc.
-        if (cp >= 0x2600 && cp <= 0x26FF) {
-            // More selective - only common emoji symbols
-            return (cp >= 0x2600 && cp <= 0x2B55) || // Various symbols
-                   (cp >= 0x2B50 && cp <= 0x2B55);   // Stars and other symbols
-        }
-        
-        // Dingbats (some emoji) (U+2700-U+27BF)
-        // Common emoji: ✂️ ✈️ ✉️ ✏️ ✒️ ✔️ ✖️ ✨ ✳️ ✴️ etc.
-        if (cp >= 0x2700 && cp <= 0x27BF) {
-            // More selective - only actual emoji
-            return (cp >= 0x2702 && cp <= 0x2705) || // Scissors, airplane, etc.
-                   (cp >= 0x2708 && cp <= 0x270F) || // Airplane, envelope, etc.
-                   (cp >= 0x2712 && cp <= 0x2714) || // Writing implements, checkmark
-                   (cp >= 0x2716 && cp <= 0x2716) || // Heavy multiplication X
-                   (cp >= 0x271D && cp <= 0x271D) || // Latin cross
-                   (cp >= 0x2721 && cp <= 0x2721) || // Star of David
-                   (cp >= 0x2728 && cp <= 0x2728) || // Sparkles
-                   (cp >= 0x2733 && cp <= 0x2734) || // Eight-pointed stars
-                   (cp >= 0x2744 && cp <= 0x2744) || // Snowflake
-                   (cp >= 0x2747 && cp <= 0x2747) || // Sparkle
-                   (cp >= 0x274C && cp <= 0x274C) || // Cross mark
-                   (cp >= 0x274E && cp <= 0x274E) || // Negative squared cross mark
-                   (cp >= 0x2753 && cp <= 0x2755) || // Question marks
-                   (cp >= 0x2757 && cp <= 0x2757) || // Heavy exclamation mark
-                   (cp >= 0x2763 && cp <= 0x2764) || // Hearts
-                   (cp >= 0x2795 && cp <= 0x2797) || // Plus/minus signs
-                   (cp >= 0x27A1 && cp <= 0x27A1) || // Arrow
-                   (cp >= 0x27B0 && cp <= 0x27B0) || // Curly loop
-                   (cp >= 0x27BF && cp <= 0x27BF);   // Double curly loop
+inline GraphemeRange graphemes(const std::string& input, bool skip_bom = true) {
+    return GraphemeRange(input, skip_bom);
+}
+
+/**
+ * @brief Number of extended grapheme clusters in a UTF-8 string
+ *
+ * ASCII runs are skipped 16 bytes at a time and counted without decoding, only CR LF pairs and the
+ * last character before non-ASCII text need the cluster rules. A leading BOM is not counted.
+ */
+inline std::size_t grapheme_count(const std::string& input) {
+    const char* data = input.data();
+    std::size_t length = input.length();
+    std::size_t pos = details::detect_bom(input).found ? 3 : 0;
+    std::size_t count = 0;
+    while (pos < length) {
+        std::size_t next = details::skip_ascii(data, pos, length);
+        if (next == pos) {
+            std::size_t chars;
+            pos = details::GraphemeSegmenter::next(input, pos, length, chars);
+            ++count;
+            continue;
         }
-        
-        // Geometric Shapes (some emoji) (U+25A0-U+25FF)
-        // Includes: ▶️ ◀️ 🔺 🔻 ⬆️ ⬇️ ⬅️ ➡️ etc.
-        if (cp >= 0x25A0 && cp <= 0x25FF) {
-            // Select only actual emoji shapes
-            return (cp >= 0x25AA && cp <= 0x25AB) || // Small squares
-                   (cp >= 0x25B6 && cp <= 0x25B6) || // Play button
-                   (cp >= 0x25C0 && cp <= 0x25C0) || // Reverse button
-                   (cp >= 0x25FB && cp <= 0x25FE);   // Various squares
+        count += next - pos;
+        const char* cr = data + pos;
+        while ((cr = static_cast<const char*>(std::memchr(cr, '\r', static_cast<std::size_t>(data + next - cr)))) != nullptr) {
+            if (cr + 1 < data + next && cr[1] == '\n') {
+                --count;
+            }
+            ++cr;
         }
-        
-        // Arrows (some emoji) (U+2190-U+21FF)
-        if (cp >= 0x2190 && cp <= 0x21FF) {
-            // Select only common arrow emoji
-            return (cp >= 0x2190 && cp <= 0x2199) || // Basic arrows
-                   (cp >= 0x21A9 && cp <= 0x21AA);   // Hooked arrows
+        pos = next;
+        unsigned char last = static_cast<unsigned char>(data[pos - 1]);
+        if (pos < length && last >= 0x20 && last != 0x7F) {
+            // The last ASCII character may start a cluster with the following combining marks
+            std::size_t chars;
+            pos = details::GraphemeSegmenter::next(input, pos - 1, length, chars);
         }
-        
-        // Additional individual emoji characters scattered in other ranges
-        // Note: © ® ™ are only emoji when followed by variation selector U+FE0F
-        // In plain form they are considered text symbols, not emoji
-        
-        // Some individual symbols commonly used as emoji
-        if (cp == 0x203C || cp == 0x2049) return true; // ‼️ ⁉️
-        // Note: ™ (U+2122) is only emoji with variation selector, not in plain form
-        if (cp == 0x2139) return true; // ℹ️
-        if (cp == 0x2194 || cp == 0x2195) return true; // ↔️ ↕️
-        if (cp == 0x2196 || cp == 0x2197 || cp == 0x2198 || cp == 0x2199) return true; // ↖️ ↗️ ↘️ ↙️
-        if (cp == 0x21A9 || cp == 0x21AA) return true; // ↩️ ↪️
-        if (cp == 0x231A || cp == 0x231B) return true; // ⌚ ⌛
-        if (cp == 0x2328) return true; // ⌨️
-        if (cp == 0x23CF) return true; // ⏏️
-        if (cp >= 0x23E9 && cp <= 0x23F3) return true; // ⏩ ⏪ ⏫ ⏬ ⏭ ⏮ ⏯ ⏰ ⏱ ⏲ ⏳
-        if (cp >= 0x23F8 && cp <= 0x23FA) return true; // ⏸ ⏹ ⏺
-        if (cp == 0x24C2) return true; // Ⓜ️
-        if (cp >= 0x25AA && cp <= 0x25AB) return true; // ▪️ ▫️
-        if (cp == 0x25B6 || cp == 0x25C0) return true; // ▶️ ◀️
-        if (cp >= 0x25FB && cp <= 0x25FE) return true; // ◻️ ◼️ ◽ ◾
-        if (cp >= 0x2934 && cp <= 0x2935) return true; // ⤴️ ⤵️
-        if (cp >= 0x2B05 && cp <= 0x2B07) return true; // ⬅️ ➡️ ⬇️
-        if (cp == 0x2B1B || cp == 0x2B1C) return true; // ⬛ ⬜
-        if (cp == 0x2B50 || cp == 0x2B55) return true; // ⭐ ⭕
-        if (cp == 0x3030) return true; // 〰️
-        if (cp == 0x303D) return true; // 〽️
-        if (cp == 0x3297 || cp == 0x3299) return true; // ㊗️ ㊙️
-        if (cp == 0x1F004) return true; // 🀄 (red dragon tile, commonly used in Mahjong)
-        if (cp == 0x1F0CF) return true; // 🃏 (joker card, commonly used in playing cards)
-        
-        return false;
-    };
+    }
+    return count;
 }
 
-} // namespace predicates
+namespace details {
 
 /**
- * @brief Converts an ASCII character to lowercase.
- * @param info The character information.
- * @return The lowercase version of the character if it's an ASCII letter (A-Z), otherwise returns the original codepoint.
- * 
- * This function only transforms ASCII uppercase letters (A-Z) to lowercase.
- * Non-ASCII characters and non-uppercase ASCII characters are returned unchanged.
+ * @brief Bytes that end a run of ASCII letters, digits and underscores
  */
-inline uint32_t to_lower_ascii(const CharInfo& info) {
-    if (info.is_ascii && info.codepoint >= 'A' && info.codepoint <= 'Z') {
-        return info.codepoint + ('a' - 'A');
-    }
-    return info.codepoint;
+inline const ByteSet& ascii_non_word_bytes() {
+    static const ByteSet set = ByteSet().insert_range(0x00, 0x2F).insert_range(0x3A, 0x40)
+                                        .insert_range(0x5B, 0x5E).insert('`').insert_range(0x7B, 0xFF);
+    return set;
 }
 
 /**
- * @brief Converts an ASCII character to uppercase.
- * @param info The character information.
- * @return The uppercase version of the character if it's an ASCII letter (a-z), otherwise returns the original codepoint.
- * 
- * This function only transforms ASCII lowercase letters (a-z) to uppercase.
- * Non-ASCII characters and non-lowercase ASCII characters are returned unchanged.
+ * @brief Word_Break of a character (with the word_extended_pictographic flag); invalid bytes are Other
  */
-inline uint32_t to_upper_ascii(const CharInfo& info) {
-    if (info.is_ascii && info.codepoint >= 'a' && info.codepoint <= 'z') {
-        return info.codepoint - ('a' - 'A');
+inline uint8_t word_class(const CharInfo& info) {
+    return info.is_valid_utf8 ? ucd::word_break(info.codepoint) : ucd::word_other;
+}
+
+/**
+ * @brief Whether the UAX #29 rules WB5, WB7a, WB8 to WB10 and WB13 to WB13b keep two adjacent
+ *        Word_Break values in one word
+ */
+inline bool word_pair_joins(uint8_t before, uint8_t after) {
+    static_assert(ucd::word_wseg_space == 18, "table below is indexed by word_break() values");
+    const uint32_t katakana = 1u << ucd::word_katakana;
+    const uint32_t letters = (1u << ucd::word_aletter) | (1u << ucd::word_hebrew_letter);
+    const uint32_t numeric = 1u << ucd::word_numeric;
+    const uint32_t extend_num_let = 1u << ucd::word_extend_num_let;
+    static const uint32_t joins[19] = {
+        0, 0, 0, 0, 0, 0, 0, 0,                                   // Other to Format
+        katakana | extend_num_let,                                // Katakana (WB13, WB13a)
+        letters | numeric | extend_num_let | (1u << ucd::word_single_quote),  // Hebrew_Letter (WB5, WB7a, WB9, WB13a)
+        letters | numeric | extend_num_let,                       // ALetter (WB5, WB9, WB13a)
+        0, 0, 0, 0, 0,                                            // Single_Quote to MidNum
+        letters | numeric | extend_num_let,                       // Numeric (WB8, WB10, WB13a)
+        letters | numeric | katakana | extend_num_let,            // ExtendNumLet (WB13a, WB13b)
+        0,                                                        // WSegSpace
+    };
+    return (joins[before] >> after) & 1u;
+}
+
+/**
+ * @brief Finds word boundaries per UAX #29
+ *
+ * Runs of ASCII letters, digits and underscores inside a word are skipped with ByteSet::find_first
+ * (32 bytes per step with SSSE3); the Word_Break table is only consulted at their ends and for
+ * other characters.
+ */
+struct WordSegmenter {
+    static const uint8_t none = 0xFF;   ///< No character, at the start or end of the text
+
+    static bool is_letter(uint8_t cls) {
+        return cls == ucd::word_aletter || cls == ucd::word_hebrew_letter;
     }
-    return info.codepoint;
+
+    static bool is_mid_num_let_q(uint8_t cls) {
+        return cls == ucd::word_mid_num_let || cls == ucd::word_single_quote;
+    }
+
+    static bool is_ignored(uint8_t cls) {
+        return cls == ucd::word_extend || cls == ucd::word_format || cls == ucd::word_zwj;
+    }
+
+    static bool is_newline(uint8_t cls) {
+        return cls == ucd::word_cr || cls == ucd::word_lf || cls == ucd::word_newline;
+    }
+
+    /**
+     * @brief Word_Break of the first character at or after pos that is not ignored by WB4
+     */
+    static uint8_t following(const std::string& str, std::size_t pos, std::size_t end) {
+        while (pos < end) {
+            CharInfo info = extract_char_info(str, pos, true, true);
+            uint8_t cls = static_cast<uint8_t>(word_class(info) & 0x1F);
+            if (!is_ignored(cls)) {
+                return cls;
+            }
+            pos += info.byte_count;
+        }
+        return none;
+    }
+
+    static std::size_t next(const std::string& str, std::size_t pos, std::size_t end, std::size_t& char_count) {
+        const char* data = str.data();
+        uint8_t before_prev = none;     // Last two characters not ignored by WB4
+        uint8_t before = none;
+        uint8_t raw_before = none;      // Character right before pos
+        std::size_t regional_indicators = 0;
+        char_count = 0;
+        while (pos < end) {
+            unsigned char byte = static_cast<unsigned char>(data[pos]);
+            if (!ascii_non_word_bytes().contains(byte) &&
+                (before == none || is_letter(before) || before == ucd::word_numeric || before == ucd::word_extend_num_let)) {
+                // ASCII letters, digits and underscores always continue a word
+                std::size_t run_end = ascii_non_word_bytes().find_first(data, pos, end);
+                before_prev = run_end - pos >= 2 ? ucd::word_break(static_cast<unsigned char>(data[run_end - 2])) : before;
+                before = ucd::word_break(static_cast<unsigned char>(data[run_end - 1]));
+                raw_before = before;
+                regional_indicators = 0;
+                char_count += run_end - pos;
+                pos = run_end;
+                continue;
+            }
+
+            CharInfo info = extract_char_info(str, pos, true, true);
+            uint8_t flags = word_class(info);
+            uint8_t after = static_cast<uint8_t>(flags & 0x1F);
+            bool joins;
+            bool ignored = false;
+            if (before == none) {
+                joins = true;                                                       // WB1
+            } else if (is_newline(raw_before)) {
+                joins = raw_before == ucd::word_cr && after == ucd::word_lf;        // WB3, WB3a
+            } else if (is_newline(after)) {
+                joins = false;                                                      // WB3b
+            } else if (raw_before == ucd::word_zwj && (flags & ucd::word_extended_pictographic) != 0) {
+                joins = true;                                                       // WB3c
+            } else if (raw_before == ucd::word_wseg_space && after == ucd::word_wseg_space) {
+                joins = true;                                                       // WB3d
+            } else if (is_ignored(after)) {
+                joins = true;                                                       // WB4
+                ignored = true;
+            } else if (word_pair_joins(before, after)) {
+                joins = true;
+            } else if (is_letter(before) && (after == ucd::word_mid_letter || is_mid_num_let_q(after))) {
+                joins = is_letter(following(str, pos + info.byte_count, end));      // WB6
+            } else if (is_letter(before_prev) && (before == ucd::word_mid_letter || is_mid_num_let_q(before)) && is_letter(after)) {
+                joins = true;                                                       // WB7
+            } else if (before == ucd::word_hebrew_letter && after == ucd::word_double_quote) {
+                joins = following(str, pos + info.byte_count, end) == ucd::word_hebrew_letter;  // WB7b
+            } else if (before_prev == ucd::word_hebrew_letter && before == ucd::word_double_quote && after == ucd::word_hebrew_letter) {
+                joins = true;                                                       // WB7c
+            } else if (before_prev == ucd::word_numeric && (before == ucd::word_mid_num || is_mid_num_let_q(before)) && after == ucd::word_numeric) {
+                joins = true;                                                       // WB11
+            } else if (before == ucd::word_numeric && (after == ucd::word_mid_num || is_mid_num_let_q(after))) {
+                joins = following(str, pos + info.byte_count, end) == ucd::word_numeric;  // WB12
+            } else if (before == ucd::word_regional_indicator && after == ucd::word_regional_indicator) {
+                joins = regional_indicators % 2 == 1;                               // WB15, WB16
+            } else {
+                joins = false;                                                      // WB999
+            }
+            if (!joins) {
+                break;
+            }
+            if (!ignored) {
+                before_prev = before;
+                before = after;
+                regional_indicators = after == ucd::word_regional_indicator ? regional_indicators + 1 : 0;
+            }
+            raw_before = after;
+            ++char_count;
+            pos += info.byte_count;
+        }
+        return pos < end ? pos : end;
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief Iterator over the word boundary segments of a string
+ */
+using WordIterator = SegmentIterator<details::WordSegmenter>;
+
+/**
+ * @brief Range of word boundary segments
+ */
+using WordRange = SegmentRange<details::WordSegmenter>;
+
+/**
+ * @brief Range over the segments between word boundaries of a UTF-8 string (UAX #29)
+ * @param input The string to segment
+ * @param skip_bom Skip a leading BOM
+ *
+ * Every byte of input belongs to one segment: words (letters and digits, including "can't",
+ * "3.14" and "e.g"), runs of spaces and single punctuation or symbol characters. Use
+ * is_word_segment() to keep only the words. Each Segment is a byte span of input.
+ *
+ * @code
+ * std::string text = u8"The quick (\"brown\") fox can't jump 32.3 feet, right?";
+ * for (const auto& w : u8scan::words(text)) {
+ *     if (u8scan::is_word_segment(text, w)) {
+ *         tokens.push_back(text.substr(w.start_pos, w.byte_count));   // The quick brown fox can't jump 32.3 feet right
+ *     }
+ * }
+ * @endcode
+ */
+inline WordRange words(const std::string& input, bool skip_bom = true) {
+    return WordRange(input, skip_bom);
 }
 
 /**
- * @brief Converts a Unicode codepoint to its UTF-8 string representation.
- * @param info The character information containing the codepoint.
- * @return The UTF-8 string representation of the codepoint.
- * 
- * This function converts any Unicode codepoint to its proper UTF-8 byte sequence.
- * For ASCII characters (< 0x80), it returns a single-byte string.
- * For non-ASCII characters, it returns the proper multi-byte UTF-8 sequence.
+ * @brief Whether a word boundary segment is a word rather than spaces, punctuation or symbols
+ *
+ * True if the segment starts with a letter, digit, Katakana or connector punctuation (Word_Break
+ * ALetter, Hebrew_Letter, Numeric, Katakana or ExtendNumLet). Ideographs and other characters
+ * that form single-character segments are Word_Break=Other and are not included.
  */
-inline std::string to_string(const CharInfo& info) {
-    std::string result;
-    uint32_t cp = info.codepoint;
-    
-    if (cp < 0x80) {
-        // ASCII character
-        result.push_back(static_cast<char>(cp));
-    } else if (cp < 0x800) {
-        // 2-byte UTF-8
-        result.push_back(static_cast<char>(0xC0 | (cp >> 6)));
-        result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
-    } else if (cp < 0x10000) {
-        // 3-byte UTF-8
-        result.push_back(static_cast<char>(0xE0 | (cp >> 12)));
-        result.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
-        result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
-    } else if (cp < 0x110000) {
-        // 4-byte UTF-8
-        result.push_back(static_cast<char>(0xF0 | (cp >> 18)));
-        result.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
-        result.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
-        result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+inline bool is_word_segment(const std::string& input, const Segment& segment) {
+    if (segment.byte_count == 0) {
+        return false;
     }
-    
-    return result;
+    CharInfo info = details::extract_char_info(input, segment.start_pos, true, true);
+    uint8_t cls = static_cast<uint8_t>(details::word_class(info) & 0x1F);
+    return cls == details::ucd::word_aletter || cls == details::ucd::word_hebrew_letter || cls == details::ucd::word_numeric ||
+           cls == details::ucd::word_katakana || cls == details::ucd::word_extend_num_let;
 }
 
+namespace details {
+
 /**
- * @brief Converts a character to lowercase and returns as a UTF-8 string.
- * @param info The character information.
- * @return The lowercase version as a UTF-8 string.
- * 
- * For ASCII characters, this function converts uppercase letters to lowercase
- * and returns other ASCII characters unchanged as single-character strings.
- * For non-ASCII characters, it returns the original character as a UTF-8 string.
+ * @brief Line_Break of a character (with the line_* flags); invalid bytes are AL
  */
-inline std::string to_lower_ascii_str(const CharInfo& info) {
-    if (info.is_ascii) {
-        char c = static_cast<char>(to_lower_ascii(info));
-        return std::string(1, c);
-    } else {
-        return to_string(info);
+inline uint8_t line_class(const CharInfo& info) {
+    return info.is_valid_utf8 ? ucd::line_break(info.codepoint) : ucd::line_al;
+}
+
+/**
+ * @brief Whether the UAX #14 rules LB23 to LB29 keep two adjacent Line_Break values on one line
+ *
+ * These rules only depend on the two values; the rules before them and LB30 to LB30b need more
+ * context and are applied by LineSegmenter.
+ */
+inline bool line_pair_joins(uint8_t before, uint8_t after) {
+    static_assert(ucd::line_ri == 37, "table below is indexed by line_break() values");
+    const uint64_t one = 1;
+    const uint64_t letters = (one << ucd::line_al) | (one << ucd::line_hl);
+    const uint64_t numeric = one << ucd::line_nu;
+    const uint64_t prefix = one << ucd::line_pr;
+    const uint64_t postfix = one << ucd::line_po;
+    const uint64_t opening = one << ucd::line_op;
+    const uint64_t ideographic = (one << ucd::line_id) | (one << ucd::line_eb) | (one << ucd::line_em);
+    const uint64_t jv = one << ucd::line_jv;
+    const uint64_t jt = one << ucd::line_jt;
+    const uint64_t hangul = (one << ucd::line_jl) | jv | jt | (one << ucd::line_h2) | (one << ucd::line_h3);
+    static const uint64_t joins[38] = {
+        letters | numeric | prefix | postfix,                     // AL (LB23, LB24, LB28)
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,                       // BK to OP
+        prefix | postfix,                                         // CL (LB25)
+        prefix | postfix,                                         // CP (LB25)
+        0, 0,                                                     // QU, EX
+        letters | numeric,                                        // IS (LB25, LB29)
+        numeric,                                                  // SY (LB25)
+        0, 0, 0, 0,                                               // NS to BB
+        numeric,                                                  // HY (LB25)
+        letters | numeric | prefix | postfix,                     // HL (LB23, LB24, LB28)
+        0,                                                        // IN
+        letters | numeric | prefix | postfix,                     // NU (LB23, LB25)
+        letters | numeric | opening | ideographic | hangul,       // PR (LB23a, LB24, LB25, LB27)
+        letters | numeric | opening,                              // PO (LB24, LB25)
+        postfix, postfix, postfix,                                // ID, EB, EM (LB23a)
+        (one << ucd::line_jl) | jv | (one << ucd::line_h2) | (one << ucd::line_h3) | postfix,  // JL (LB26, LB27)
+        jv | jt | postfix,                                        // JV (LB26, LB27)
+        jt | postfix,                                             // JT (LB26, LB27)
+        jv | jt | postfix,                                        // H2 (LB26, LB27)
+        jt | postfix,                                             // H3 (LB26, LB27)
+        0,                                                        // RI
+    };
+    return (joins[before] >> after) & 1u;
+}
+
+/**
+ * @brief Finds line break opportunities per UAX #14
+ *
+ * Each segment ends right before a break opportunity, so it contains the trailing spaces and
+ * mandatory breaks of a line. Runs of ASCII letters, digits and underscores, which never allow a
+ * break, are skipped with ByteSet::find_first; the Line_Break table is only consulted at their
+ * ends and for other characters.
+ */
+struct LineSegmenter {
+    static const uint8_t none = 0xFF;   ///< No character, at the start of the text
+
+    static bool is_mandatory(uint8_t cls) {
+        return cls == ucd::line_bk || cls == ucd::line_cr || cls == ucd::line_lf || cls == ucd::line_nl;
     }
+
+    static bool is_letter_or_digit(uint8_t cls) {
+        return cls == ucd::line_al || cls == ucd::line_hl || cls == ucd::line_nu;
+    }
+
+    static std::size_t next(const std::string& str, std::size_t pos, std::size_t end, std::size_t& char_count) {
+        const char* data = str.data();
+        uint8_t before_prev = none;     // Last two characters after LB9 and LB10
+        uint8_t before = none;
+        uint8_t before_flags = 0;
+        uint8_t raw_before = none;      // Character right before pos
+        uint8_t before_spaces = none;   // Last character before a run of spaces (LB8, LB14 to LB17)
+        std::size_t regional_indicators = 0;
+        char_count = 0;
+        while (pos < end) {
+            unsigned char byte = static_cast<unsigned char>(data[pos]);
+            if (!ascii_non_word_bytes().contains(byte) && (before == none || is_letter_or_digit(before))) {
+                // ASCII letters, digits and underscores are AL or NU, which never break (LB23, LB25, LB28)
+                std::size_t run_end = ascii_non_word_bytes().find_first(data, pos, end);
+                before_prev = run_end - pos >= 2 ? ucd::line_break(static_cast<unsigned char>(data[run_end - 2])) : before;
+                before = ucd::line_break(static_cast<unsigned char>(data[run_end - 1]));
+                before_flags = before;
+                raw_before = before;
+                regional_indicators = 0;
+                char_count += run_end - pos;
+                pos = run_end;
+                continue;
+            }
+
+            CharInfo info = extract_char_info(str, pos, true, true);
+            uint8_t flags = line_class(info);
+            uint8_t cls = static_cast<uint8_t>(flags & 0x3F);
+            bool combining = cls == ucd::line_cm || cls == ucd::line_zwj;
+            if (combining) {
+                flags = ucd::line_al;                                               // LB10, unless attached by LB9
+            }
+            uint8_t after = static_cast<uint8_t>(flags & 0x3F);
+            bool joins;
+            bool attached = false;
+            if (before == none) {
+                joins = true;                                                       // LB2
+            } else if (is_mandatory(raw_before)) {
+                joins = raw_before == ucd::line_cr && after == ucd::line_lf;        // LB4, LB5
+            } else if (is_mandatory(after) || after == ucd::line_sp || after == ucd::line_zw) {
+                joins = true;                                                       // LB6, LB7
+            } else if (before == ucd::line_zw || (before == ucd::line_sp && before_spaces == ucd::line_zw)) {
+                joins = false;                                                      // LB8
+            } else if (combining && before != ucd::line_sp && before != ucd::line_zw) {
+                joins = true;                                                       // LB9
+                attached = true;
+            } else if (raw_before == ucd::line_zwj) {
+                joins = true;                                                       // LB8a
+            } else {
+                uint8_t context = before == ucd::line_sp ? before_spaces : before;
+                if (before == ucd::line_wj || after == ucd::line_wj) {
+                    joins = true;                                                   // LB11
+                } else if (before == ucd::line_gl) {
+                    joins = true;                                                   // LB12
+                } else if (after == ucd::line_gl && before != ucd::line_sp && before != ucd::line_ba && before != ucd::line_hy) {
+                    joins = true;                                                   // LB12a
+                } else if (after == ucd::line_cl || after == ucd::line_cp || after == ucd::line_ex ||
+                           after == ucd::line_is || after == ucd::line_sy) {
+                    joins = true;                                                   // LB13
+                } else if (context == ucd::line_op) {
+                    joins = true;                                                   // LB14
+                } else if (context == ucd::line_qu && after == ucd::line_op) {
+                    joins = true;                                                   // LB15
+                } else if ((context == ucd::line_cl || context == ucd::line_cp) && after == ucd::line_ns) {
+                    joins = true;                                                   // LB16
+                } else if (context == ucd::line_b2 && after == ucd::line_b2) {
+                    joins = true;                                                   // LB17
+                } else if (before == ucd::line_sp) {
+                    joins = false;                                                  // LB18
+                } else if (before == ucd::line_qu || after == ucd::line_qu) {
+                    joins = true;                                                   // LB19
+                } else if (before == ucd::line_cb || after == ucd::line_cb) {
+                    joins = false;                                                  // LB20
+                } else if (after == ucd::line_ba || after == ucd::line_hy || after == ucd::line_ns || before == ucd::line_bb) {
+                    joins = true;                                                   // LB21
+                } else if (before_prev == ucd::line_hl && (before == ucd::line_hy || before == ucd::line_ba)) {
+                    joins = true;                                                   // LB21a
+                } else if ((before == ucd::line_sy && after == ucd::line_hl) || after == ucd::line_in) {
+                    joins = true;                                                   // LB21b, LB22
+                } else if (line_pair_joins(before, after)) {
+                    joins = true;                                                   // LB23 to LB29
+                } else if (is_letter_or_digit(before) && after == ucd::line_op) {
+                    joins = (flags & ucd::line_east_asian) == 0;                    // LB30
+                } else if (before == ucd::line_cp && is_letter_or_digit(after)) {
+                    joins = (before_flags & ucd::line_east_asian) == 0;             // LB30
+                } else if (before == ucd::line_ri && after == ucd::line_ri) {
+                    joins = regional_indicators % 2 == 1;                           // LB30a
+                } else if (after == ucd::line_em) {
+                    joins = before == ucd::line_eb || (before_flags & ucd::line_unassigned_pictographic) != 0;  // LB30b
+                } else {
+                    joins = false;                                                  // LB31
+                }
+            }
+            if (!joins) {
+                break;
+            }
+            if (!attached) {
+                if (after == ucd::line_sp && before != ucd::line_sp) {
+                    before_spaces = before;
+                }
+                before_prev = before;
+                before = after;
+                before_flags = flags;
+                regional_indicators = after == ucd::line_ri ? regional_indicators + 1 : 0;
+            }
+            raw_before = cls;
+            ++char_count;
+            pos += info.byte_count;
+        }
+        return pos < end ? pos : end;
+    }
+};
+
+} // namespace details
+
+/**
+ * @brief Iterator over the segments between line break opportunities of a string
+ */
+using LineBreakIterator = SegmentIterator<details::LineSegmenter>;
+
+/**
+ * @brief Range of segments between line break opportunities
+ */
+using LineBreakRange = SegmentRange<details::LineSegmenter>;
+
+/**
+ * @brief Range over the segments between line break opportunities of a UTF-8 string (UAX #14)
+ * @param input The string to segment
+ * @param skip_bom Skip a leading BOM
+ *
+ * A line may be broken after each segment and nowhere inside one. Segments keep their trailing
+ * spaces and line terminators; is_mandatory_break() tells whether the text must be broken after
+ * a segment. Every byte of input belongs to one segment, found in a single pass without
+ * allocating. Line_Break values follow the default UAX #14 rules with LB1 resolution: ambiguous
+ * and unknown characters are AL, complex-context (SA) characters are AL or CM, CJ is NS.
+ *
+ * @code
+ * // Greedy wrapping to 20 characters
+ * std::string line;
+ * std::size_t width = 0;
+ * for (const auto& s : u8scan::line_breaks(text)) {
+ *     if (width + s.char_count > 20 && !line.empty()) {
+ *         lines.push_back(line);
+ *         line.clear();
+ *         width = 0;
+ *     }
+ *     line.append(text, s.start_pos, s.byte_count);
+ *     width += s.char_count;
+ *     if (u8scan::is_mandatory_break(text, s)) {
+ *         lines.push_back(line);
+ *         line.clear();
+ *         width = 0;
+ *     }
+ * }
+ * @endcode
+ */
+inline LineBreakRange line_breaks(const std::string& input, bool skip_bom = true) {
+    return LineBreakRange(input, skip_bom);
 }
 
 /**
- * @brief Converts a character to uppercase and returns as a UTF-8 string.
- * @param info The character information.
- * @return The uppercase version as a UTF-8 string.
- * 
- * For ASCII characters, this function converts lowercase letters to uppercase
- * and returns other ASCII characters unchanged as single-character strings.
- * For non-ASCII characters, it returns the original character as a UTF-8 string.
+ * @brief Whether a line break segment ends with a mandatory break
+ *
+ * True if the last character of the segment is a line terminator (Line_Break BK, CR, LF or NL:
+ * LF, VT, FF, CR, NEL, U+2028 and U+2029).
  */
-inline std::string to_upper_ascii_str(const CharInfo& info) {
-    if (info.is_ascii) {
-        char c = static_cast<char>(to_upper_ascii(info));
-        return std::string(1, c);
-    } else {
-        return to_string(info);
+inline bool is_mandatory_break(const std::string& input, const Segment& segment) {
+    if (segment.byte_count == 0) {
+        return false;
+    }
+    std::size_t pos = segment.end_pos() - 1;
+    while (pos > segment.start_pos && segment.end_pos() - pos < 4 && (static_cast<unsigned char>(input[pos]) & 0xC0) == 0x80) {
+        --pos;
     }
+    CharInfo info = details::extract_char_info(input, pos, true, true);
+    return pos + info.byte_count == segment.end_pos() && details::LineSegmenter::is_mandatory(details::line_class(info));
 }
 
 /**
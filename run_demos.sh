@@ -67,12 +67,23 @@ else
     access_demo_success=false
 fi
 
+# Run the predicates benchmark
+echo ""
+echo -e "${BLUE}--- Running u8scan_predicates_benchmark ---${NC}"
+if "$BUILD_DIR/bin/u8scan_predicates_benchmark"; then
+    echo -e "${GREEN}--- u8scan_predicates_benchmark completed successfully ---${NC}"
+    predicates_benchmark_success=true
+else
+    echo -e "${RED}--- u8scan_predicates_benchmark failed ---${NC}"
+    predicates_benchmark_success=false
+fi
+
 # Summary
 echo ""
 echo -e "${BLUE}Demo Summary:${NC}"
 echo "============="
 
-if $scanning_demo_success && $stl_demo_success && $access_demo_success; then
+if $scanning_demo_success && $stl_demo_success && $access_demo_success && $predicates_benchmark_success; then
     echo -e "${GREEN}✓ All demos completed successfully!${NC}"
     exit 0
 else
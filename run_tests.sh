@@ -38,14 +38,28 @@ U8SCAN_STL_TEST_BIN="$BUILD_DIR/bin/u8scan_stl_test"
 U8SCAN_EMOJI_TEST_BIN="$BUILD_DIR/bin/u8scan_emoji_test"
 U8SCAN_COPY_TEST_BIN="$BUILD_DIR/bin/u8scan_copy_test"
 U8SCAN_ACCESS_TEST_BIN="$BUILD_DIR/bin/u8scan_access_test"
-
-if [ ! -x "$U8SCAN_SCANNING_TEST_BIN" ] || [ ! -x "$U8SCAN_STL_TEST_BIN" ] || [ ! -x "$U8SCAN_EMOJI_TEST_BIN" ] || [ ! -x "$U8SCAN_COPY_TEST_BIN" ] || [ ! -x "$U8SCAN_ACCESS_TEST_BIN" ]; then
+U8SCAN_PARALLEL_TEST_BIN="$BUILD_DIR/bin/u8scan_parallel_test"
+U8SCAN_ESCAPE_TEST_BIN="$BUILD_DIR/bin/u8scan_escape_test"
+U8SCAN_CASE_TEST_BIN="$BUILD_DIR/bin/u8scan_case_test"
+U8SCAN_NORMALIZATION_TEST_BIN="$BUILD_DIR/bin/u8scan_normalization_test"
+U8SCAN_SEGMENTATION_TEST_BIN="$BUILD_DIR/bin/u8scan_segmentation_test"
+U8SCAN_PREDICATES_TEST_BIN="$BUILD_DIR/bin/u8scan_predicates_test"
+U8SCAN_ANALYSIS_TEST_BIN="$BUILD_DIR/bin/u8scan_analysis_test"
+
+if [ ! -x "$U8SCAN_SCANNING_TEST_BIN" ] || [ ! -x "$U8SCAN_STL_TEST_BIN" ] || [ ! -x "$U8SCAN_EMOJI_TEST_BIN" ] || [ ! -x "$U8SCAN_COPY_TEST_BIN" ] || [ ! -x "$U8SCAN_ACCESS_TEST_BIN" ] || [ ! -x "$U8SCAN_PARALLEL_TEST_BIN" ] || [ ! -x "$U8SCAN_ESCAPE_TEST_BIN" ] || [ ! -x "$U8SCAN_CASE_TEST_BIN" ] || [ ! -x "$U8SCAN_NORMALIZATION_TEST_BIN" ] || [ ! -x "$U8SCAN_SEGMENTATION_TEST_BIN" ] || [ ! -x "$U8SCAN_PREDICATES_TEST_BIN" ] || [ ! -x "$U8SCAN_ANALYSIS_TEST_BIN" ]; then
     echo -e "${RED}Test binaries not found or not executable:${NC}"
     [ ! -x "$U8SCAN_SCANNING_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_SCANNING_TEST_BIN${NC}"
     [ ! -x "$U8SCAN_STL_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_STL_TEST_BIN${NC}"
     [ ! -x "$U8SCAN_EMOJI_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_EMOJI_TEST_BIN${NC}"
     [ ! -x "$U8SCAN_COPY_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_COPY_TEST_BIN${NC}"
     [ ! -x "$U8SCAN_ACCESS_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_ACCESS_TEST_BIN${NC}"
+    [ ! -x "$U8SCAN_PARALLEL_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_PARALLEL_TEST_BIN${NC}"
+    [ ! -x "$U8SCAN_ESCAPE_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_ESCAPE_TEST_BIN${NC}"
+    [ ! -x "$U8SCAN_CASE_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_CASE_TEST_BIN${NC}"
+    [ ! -x "$U8SCAN_NORMALIZATION_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_NORMALIZATION_TEST_BIN${NC}"
+    [ ! -x "$U8SCAN_SEGMENTATION_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_SEGMENTATION_TEST_BIN${NC}"
+    [ ! -x "$U8SCAN_PREDICATES_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_PREDICATES_TEST_BIN${NC}"
+    [ ! -x "$U8SCAN_ANALYSIS_TEST_BIN" ] && echo -e "${RED}- $U8SCAN_ANALYSIS_TEST_BIN${NC}"
     echo -e "${YELLOW}Try running the rebuild script first: ./rebuild.sh${NC}"
     exit 1
 fi
@@ -80,8 +94,43 @@ echo -e "${BLUE}Running U8Scan Access Tests:${NC}"
 "$U8SCAN_ACCESS_TEST_BIN"
 access_exit_code=$?
 
+echo ""
+echo -e "${BLUE}Running U8Scan Parallel Tests:${NC}"
+"$U8SCAN_PARALLEL_TEST_BIN"
+parallel_exit_code=$?
+
+echo ""
+echo -e "${BLUE}Running U8Scan Escape Tests:${NC}"
+"$U8SCAN_ESCAPE_TEST_BIN"
+escape_exit_code=$?
+
+echo ""
+echo -e "${BLUE}Running U8Scan Case Tests:${NC}"
+"$U8SCAN_CASE_TEST_BIN"
+case_exit_code=$?
+
+echo ""
+echo -e "${BLUE}Running U8Scan Normalization Tests:${NC}"
+"$U8SCAN_NORMALIZATION_TEST_BIN"
+normalization_exit_code=$?
+
+echo ""
+echo -e "${BLUE}Running U8Scan Segmentation Tests:${NC}"
+"$U8SCAN_SEGMENTATION_TEST_BIN"
+segmentation_exit_code=$?
+
+echo ""
+echo -e "${BLUE}Running U8Scan Predicates Tests:${NC}"
+"$U8SCAN_PREDICATES_TEST_BIN"
+predicates_exit_code=$?
+
+echo ""
+echo -e "${BLUE}Running U8Scan Analysis Tests:${NC}"
+"$U8SCAN_ANALYSIS_TEST_BIN"
+analysis_exit_code=$?
+
 # Check exit codes
-if [ $scanning_exit_code -eq 0 ] && [ $stl_exit_code -eq 0 ] && [ $emoji_exit_code -eq 0 ] && [ $copy_exit_code -eq 0 ] && [ $access_exit_code -eq 0 ]; then
+if [ $scanning_exit_code -eq 0 ] && [ $stl_exit_code -eq 0 ] && [ $emoji_exit_code -eq 0 ] && [ $copy_exit_code -eq 0 ] && [ $access_exit_code -eq 0 ] && [ $parallel_exit_code -eq 0 ] && [ $escape_exit_code -eq 0 ] && [ $case_exit_code -eq 0 ] && [ $normalization_exit_code -eq 0 ] && [ $segmentation_exit_code -eq 0 ] && [ $predicates_exit_code -eq 0 ] && [ $analysis_exit_code -eq 0 ]; then
     exit_code=0
 else
     exit_code=1
@@ -644,6 +644,109 @@ UTEST_FUNC_DEF2(U8ScanAccess, StringAnalysisASCIIOnly) {
     UTEST_ASSERT_TRUE(digit_char.is_ascii);
 }
 
+// Test prefix_bytes() and suffix_bytes() against character-by-character copies
+UTEST_FUNC_DEF2(U8ScanAccess, PrefixSuffixBytes) {
+    std::string text = u8"Hello 世界! Ünïcödé 🌍🚀 ";
+    std::string input;
+    for (int i = 0; i < 5; ++i) input += text;
+    std::size_t count = u8scan::length(input);
+
+    for (std::size_t n = 0; n <= count + 2; ++n) {
+        std::string expected_prefix;
+        u8scan::copy_n(input, std::back_inserter(expected_prefix), n);
+        UTEST_ASSERT_TRUE(input.substr(0, u8scan::prefix_bytes(input, n)) == expected_prefix);
+
+        std::size_t skip = n < count ? count - n : 0;
+        std::string expected_suffix;
+        u8scan::copy_from(input, std::back_inserter(expected_suffix),
+                          [&skip](const CharInfo&) { return skip == 0 || skip-- == 0; });
+        UTEST_ASSERT_TRUE(input.substr(input.length() - u8scan::suffix_bytes(input, n)) == expected_suffix);
+    }
+
+    // BOM is kept in the prefix and never counted
+    std::string with_bom = bom_str() + u8"世界abc";
+    UTEST_ASSERT_EQUALS(3u, u8scan::prefix_bytes(with_bom, 0));
+    UTEST_ASSERT_EQUALS(9u, u8scan::prefix_bytes(with_bom, 2));
+    UTEST_ASSERT_EQUALS(with_bom.length(), u8scan::prefix_bytes(with_bom, 100));
+    UTEST_ASSERT_EQUALS(with_bom.length() - 3, u8scan::suffix_bytes(with_bom, 100));
+    UTEST_ASSERT_EQUALS(0u, u8scan::suffix_bytes(bom_str(), 1));
+
+    // Empty input and huge counts
+    UTEST_ASSERT_EQUALS(0u, u8scan::prefix_bytes("", 5));
+    UTEST_ASSERT_EQUALS(0u, u8scan::suffix_bytes("", 5));
+    UTEST_ASSERT_EQUALS(input.length(), u8scan::prefix_bytes(input, static_cast<std::size_t>(-1)));
+
+    // Boundaries never split a multi-byte sequence of malformed input
+    std::string malformed = std::string(u8"ab世") + "\x80\x80" + std::string(40, 'x') + "\xE4\xB8" + u8"界";
+    for (std::size_t n = 0; n < 50; ++n) {
+        std::size_t prefix = u8scan::prefix_bytes(malformed, n);
+        std::size_t suffix = u8scan::suffix_bytes(malformed, n);
+        UTEST_ASSERT_TRUE(prefix == malformed.length() || (static_cast<unsigned char>(malformed[prefix]) & 0xC0) != 0x80);
+        UTEST_ASSERT_TRUE(suffix == 0 || (static_cast<unsigned char>(malformed[malformed.length() - suffix]) & 0xC0) != 0x80);
+    }
+    UTEST_ASSERT_EQUALS(7u, u8scan::prefix_bytes(malformed, 3));  // "ab世" plus the stray continuation bytes
+
+    // An empty prefix is empty even before stray continuation bytes
+    std::string leading = std::string("\x80\x80") + u8"ab世";
+    std::string expected_empty;
+    u8scan::copy_n(leading, std::back_inserter(expected_empty), 0);
+    UTEST_ASSERT_TRUE(leading.substr(0, u8scan::prefix_bytes(leading, 0)) == expected_empty);
+    UTEST_ASSERT_EQUALS(0u, u8scan::prefix_bytes(leading, 0));
+    UTEST_ASSERT_EQUALS(3u, u8scan::prefix_bytes(leading, 1));
+    UTEST_ASSERT_EQUALS(3u, u8scan::prefix_bytes(bom_str() + leading, 0));
+}
+
+// Test display_width() of wide, zero-width and emoji characters
+UTEST_FUNC_DEF2(U8ScanAccess, DisplayWidth) {
+    UTEST_ASSERT_EQUALS(0u, u8scan::display_width(""));
+    UTEST_ASSERT_EQUALS(0u, u8scan::display_width(bom_str()));
+    UTEST_ASSERT_EQUALS(13u, u8scan::display_width("Hello, world!"));
+    UTEST_ASSERT_EQUALS(5u, u8scan::display_width(u8"世界!"));
+    UTEST_ASSERT_EQUALS(4u, u8scan::display_width(u8"ｆｕ"));               // Fullwidth forms
+    UTEST_ASSERT_EQUALS(4u, u8scan::display_width(u8"한국"));                // Hangul syllables
+    UTEST_ASSERT_EQUALS(2u, u8scan::display_width(u8"\u1112\u1161\u11AB"));   // Conjoining jamo L V T
+    UTEST_ASSERT_EQUALS(4u, u8scan::display_width(u8"cafe\u0301"));           // Combining mark
+    UTEST_ASSERT_EQUALS(3u, u8scan::display_width(u8"a\u200Bb\u00AD"));       // ZWSP is invisible, soft hyphen is not
+    UTEST_ASSERT_EQUALS(2u, u8scan::display_width("a\tb\n"));                 // Control characters
+    UTEST_ASSERT_EQUALS(4u, u8scan::display_width(u8"🌍🚀"));
+    UTEST_ASSERT_EQUALS(1u, u8scan::display_width(u8"\u2764"));               // Text presentation by default
+    UTEST_ASSERT_EQUALS(2u, u8scan::display_width(u8"\u2764\uFE0F"));         // Emoji presentation selector
+    UTEST_ASSERT_EQUALS(2u, u8scan::display_width(u8"1\uFE0F\u20E3"));        // Keycap
+    UTEST_ASSERT_EQUALS(2u, u8scan::display_width(u8"🌍\uFE0F"));             // Already wide
+    UTEST_ASSERT_EQUALS(4u, u8scan::display_width(std::string("a\xFF") + "\xE4\xB8"));  // One column per invalid byte
+
+    // ASCII runs of every length around wide characters
+    for (std::size_t run = 0; run < 70; ++run) {
+        std::string ascii(run, 'x');
+        UTEST_ASSERT_EQUALS(run * 2 + 5, u8scan::display_width(ascii + u8"世" + ascii + u8"e\u0301\u2764\uFE0F"));
+        UTEST_ASSERT_EQUALS(run, u8scan::display_width(ascii + "\x7F" + "\x01"));
+    }
+}
+
+// Test truncate_to_width() at every width
+UTEST_FUNC_DEF2(U8ScanAccess, TruncateToWidth) {
+    UTEST_ASSERT_STR_EQUALS(u8"日本", u8scan::truncate_to_width(u8"日本語テキスト", 5).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"日本語", u8scan::truncate_to_width(u8"日本語テキスト", 6).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"cafe\u0301", u8scan::truncate_to_width(u8"cafe\u0301 au lait", 4).c_str());   // Marks stay with the base
+    UTEST_ASSERT_STR_EQUALS(u8"ab\u2764\uFE0F", u8scan::truncate_to_width(u8"ab\u2764\uFE0F!", 4).c_str());
+    UTEST_ASSERT_STR_EQUALS("ab", u8scan::truncate_to_width(u8"ab\u2764\uFE0F!", 3).c_str());          // FE0F makes the heart 2 wide
+    UTEST_ASSERT_STR_EQUALS("", u8scan::truncate_to_width(u8"世界", 1).c_str());
+    UTEST_ASSERT_STR_EQUALS("", u8scan::truncate_to_width("", 10).c_str());
+    UTEST_ASSERT_TRUE(u8scan::truncate_to_width(bom_str() + "abc", 2) == bom_str() + "ab");
+
+    std::string text;
+    for (int i = 0; i < 4; ++i) text += u8"Plain text, 世界 and e\u0301mojis \u2764\uFE0F🌍 ";
+    std::size_t total = u8scan::display_width(text);
+    for (std::size_t cols = 0; cols <= total + 1; ++cols) {
+        std::string prefix = u8scan::truncate_to_width(text, cols);
+        std::size_t width = u8scan::display_width(prefix);
+        UTEST_ASSERT_TRUE(width <= cols && width + 1 >= std::min(cols, total));
+        UTEST_ASSERT_TRUE(text.compare(0, prefix.length(), prefix) == 0);
+        UTEST_ASSERT_EQUALS(u8scan::length(prefix), u8scan::length(text.substr(0, prefix.length())));
+        UTEST_ASSERT_TRUE(prefix.length() == text.length() || (static_cast<unsigned char>(text[prefix.length()]) & 0xC0) != 0x80);
+    }
+}
+
 // Main test runner
 int main() {
     UTEST_PROLOG();
@@ -663,6 +766,9 @@ int main() {
     UTEST_FUNC2(U8ScanAccess, LengthASCIIMode);
     UTEST_FUNC2(U8ScanAccess, LengthInvalidUTF8);
     UTEST_FUNC2(U8ScanAccess, LengthEdgeCases);
+    UTEST_FUNC2(U8ScanAccess, PrefixSuffixBytes);
+    UTEST_FUNC2(U8ScanAccess, DisplayWidth);
+    UTEST_FUNC2(U8ScanAccess, TruncateToWidth);
     
     // Comprehensive BOM tests
     UTEST_FUNC2(U8ScanAccess, ComprehensiveBOMTests);
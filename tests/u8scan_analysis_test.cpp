@@ -0,0 +1,290 @@
+#include "../include/utest/utest.h"
+#include "../include/u8scan/u8scan.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace u8scan;
+
+namespace {
+
+// Number of characters of make_char_range(input) matching a predicate
+template<typename Predicate>
+std::size_t count_chars(const std::string& input, Predicate pred) {
+    auto range = make_char_range(input);
+    return static_cast<std::size_t>(std::count_if(range.begin(), range.end(), pred));
+}
+
+// Largest codepoint of the valid characters of input
+uint32_t max_valid_codepoint(const std::string& input) {
+    uint32_t result = 0;
+    for (const auto& info : make_char_range(input)) {
+        if (info.is_valid_utf8) {
+            result = std::max(result, info.codepoint);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+// Test the statistics of a mixed string field by field
+UTEST_FUNC_DEF2(U8ScanAnalysis, Counts) {
+    TextStats stats = analyze(u8"Hello 世界 🌍! é\u00A0x\u3000");
+    UTEST_ASSERT_EQUALS(27u, stats.bytes);
+    UTEST_ASSERT_EQUALS(16u, stats.codepoints);
+    UTEST_ASSERT_EQUALS(10u, stats.ascii);
+    UTEST_ASSERT_EQUALS(2u, stats.two_byte);
+    UTEST_ASSERT_EQUALS(3u, stats.three_byte);
+    UTEST_ASSERT_EQUALS(1u, stats.four_byte);
+    UTEST_ASSERT_EQUALS(0u, stats.invalid_bytes);
+    UTEST_ASSERT_EQUALS(1u, stats.emoji);
+    UTEST_ASSERT_EQUALS(5u, stats.whitespace);    // Three spaces, U+00A0 and U+3000
+    UTEST_ASSERT_TRUE(!stats.has_bom);
+    UTEST_ASSERT_EQUALS(0x1F30Du, stats.max_codepoint);
+
+    // Empty input, ASCII only, BOM and invalid bytes
+    TextStats empty = analyze("");
+    UTEST_ASSERT_EQUALS(0u, empty.bytes);
+    UTEST_ASSERT_EQUALS(0u, empty.codepoints);
+    UTEST_ASSERT_EQUALS(0u, empty.max_codepoint);
+
+    TextStats ascii = analyze(std::string(100, 'a') + "~\t\n" + std::string(50, '0'));
+    UTEST_ASSERT_EQUALS(153u, ascii.codepoints);
+    UTEST_ASSERT_EQUALS(153u, ascii.ascii);
+    UTEST_ASSERT_EQUALS(2u, ascii.whitespace);
+    UTEST_ASSERT_EQUALS(static_cast<uint32_t>('~'), ascii.max_codepoint);
+
+    TextStats bom = analyze(bom_str() + "a" + "\xFF\xC3" + u8"é" + "\xE4\xB8");
+    UTEST_ASSERT_TRUE(bom.has_bom);
+    UTEST_ASSERT_EQUALS(10u, bom.bytes);
+    UTEST_ASSERT_EQUALS(2u, bom.codepoints);
+    UTEST_ASSERT_EQUALS(4u, bom.invalid_bytes);
+    UTEST_ASSERT_EQUALS(0xE9u, bom.max_codepoint);
+
+    TextStats only_invalid = analyze("\x80\x80");
+    UTEST_ASSERT_EQUALS(2u, only_invalid.invalid_bytes);
+    UTEST_ASSERT_EQUALS(0u, only_invalid.max_codepoint);
+}
+
+// Test that the statistics agree with length() and count_if() for every block alignment
+UTEST_FUNC_DEF2(U8ScanAnalysis, MatchesIteratorCounts) {
+    std::vector<std::string> chunks = {
+        u8"The quick brown fox\tjumps over the lazy dog.\n",
+        u8"Ünïcödé tëxt, 世界 and emoji 🌍🚀🇺🇸 © \u0085",
+        std::string("ab\xC3(\xFF\xE4\xB8") + u8"ü" + "\xF0\x9F\x8C" + "z",
+        std::string(40, ' ') + u8"　  " + std::string(20, '\x7F'),
+    };
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            std::string text = std::string(offset, 'x') + chunks[i] + chunks[(i + 1) % chunks.size()];
+            if (offset % 5 == 0) {
+                text = bom_str() + text;
+            }
+            TextStats stats = analyze(text);
+            UTEST_ASSERT_EQUALS(text.length(), stats.bytes);
+            UTEST_ASSERT_EQUALS(length(text), stats.codepoints + stats.invalid_bytes);
+            UTEST_ASSERT_EQUALS(count_chars(text, predicates::is_valid_t()), stats.codepoints);
+            UTEST_ASSERT_EQUALS(count_chars(text, predicates::is_ascii_t()), stats.ascii);
+            UTEST_ASSERT_EQUALS(count_chars(text, predicates::is_utf8_t()),
+                                stats.two_byte + stats.three_byte + stats.four_byte + stats.invalid_bytes);
+            UTEST_ASSERT_EQUALS(count_chars(text, predicates::is_emoji_t()), stats.emoji);
+            UTEST_ASSERT_EQUALS(count_chars(text, predicates::is_whitespace_t()), stats.whitespace);
+            UTEST_ASSERT_EQUALS(offset % 5 == 0, stats.has_bom);
+            UTEST_ASSERT_EQUALS(max_valid_codepoint(text), stats.max_codepoint);
+        }
+    }
+}
+
+// Test script() and script_name() for representative characters
+UTEST_FUNC_DEF2(U8ScanAnalysis, Scripts) {
+    UTEST_ASSERT_TRUE(script('a') == Script::Latin);
+    UTEST_ASSERT_TRUE(script(0x00E9) == Script::Latin);
+    UTEST_ASSERT_TRUE(script('7') == Script::Common);
+    UTEST_ASSERT_TRUE(script(' ') == Script::Common);
+    UTEST_ASSERT_TRUE(script(0x0301) == Script::Inherited);
+    UTEST_ASSERT_TRUE(script(0x0416) == Script::Cyrillic);
+    UTEST_ASSERT_TRUE(script(0x03A9) == Script::Greek);
+    UTEST_ASSERT_TRUE(script(0x05D0) == Script::Hebrew);
+    UTEST_ASSERT_TRUE(script(0x0627) == Script::Arabic);
+    UTEST_ASSERT_TRUE(script(0x0915) == Script::Devanagari);
+    UTEST_ASSERT_TRUE(script(0x4E16) == Script::Han);
+    UTEST_ASSERT_TRUE(script(0x3042) == Script::Hiragana);
+    UTEST_ASSERT_TRUE(script(0x30A2) == Script::Katakana);
+    UTEST_ASSERT_TRUE(script(0xAC00) == Script::Hangul);
+    UTEST_ASSERT_TRUE(script(0x20000) == Script::Han);
+    UTEST_ASSERT_TRUE(script(0x1F30D) == Script::Common);
+    UTEST_ASSERT_TRUE(script(0x0378) == Script::Unknown);
+    UTEST_ASSERT_TRUE(script(0x110000) == Script::Unknown);
+    UTEST_ASSERT_STR_EQUALS("Latin", script_name(Script::Latin));
+    UTEST_ASSERT_STR_EQUALS("Old_Italic", script_name(Script::Old_Italic));
+    UTEST_ASSERT_STR_EQUALS("Unknown", script_name(static_cast<Script>(255)));
+}
+
+// Test script_histogram() against per-character lookups for every block alignment
+UTEST_FUNC_DEF2(U8ScanAnalysis, ScriptHistogram) {
+    ScriptHistogram histogram = script_histogram(u8"Привет, мир! Hello");
+    UTEST_ASSERT_EQUALS(9u, histogram.count(Script::Cyrillic));
+    UTEST_ASSERT_EQUALS(5u, histogram.count(Script::Latin));
+    UTEST_ASSERT_EQUALS(4u, histogram.count(Script::Common));
+    UTEST_ASSERT_TRUE(histogram.dominant() == Script::Cyrillic);
+
+    UTEST_ASSERT_TRUE(script_histogram("").dominant() == Script::Common);
+    UTEST_ASSERT_TRUE(script_histogram("123 !?").dominant() == Script::Common);
+    UTEST_ASSERT_TRUE(script_histogram(u8"日本語のテキスト").dominant() == Script::Katakana);   // 3 Han, 1 Hiragana, 4 Katakana
+    UTEST_ASSERT_TRUE(script_histogram(u8"ab αβ").dominant() == Script::Greek);          // Ties go to the first in Script order
+
+    std::string chunk = std::string(u8"Hello, 世界! Ünïcödé Ωμέγα Привет שלום 🌍 ") + "\xFF\xE4\xB8" + u8"x́";
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        std::string text = std::string(offset, 'x') + chunk + std::string(offset % 3, '1');
+        if (offset % 5 == 0) {
+            text = bom_str() + text;
+        }
+        std::vector<std::size_t> expected(details::ucd::script_count, 0);
+        for (const auto& info : make_char_range(text)) {
+            if (info.is_valid_utf8) {
+                ++expected[static_cast<std::size_t>(script(info.codepoint))];
+            }
+        }
+        histogram = script_histogram(text);
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            UTEST_ASSERT_EQUALS(expected[i], histogram.counts[i]);
+        }
+        UTEST_ASSERT_TRUE(histogram.dominant() == Script::Latin);
+    }
+}
+
+// Test line starts, line ends and positions of a small source text
+UTEST_FUNC_DEF2(U8ScanAnalysis, LineIndex) {
+    std::string source = u8"let x = 1;\nlet y = \"世界\" +;\r\n\nend";
+    LineIndex index(source);
+    UTEST_ASSERT_EQUALS(4u, index.line_count());
+    UTEST_ASSERT_EQUALS(0u, index.line_start(0));
+    UTEST_ASSERT_EQUALS(10u, index.line_end(0));
+    UTEST_ASSERT_EQUALS(11u, index.line_start(1));
+    UTEST_ASSERT_EQUALS(source.find('\n', 11), index.line_end(1));
+    UTEST_ASSERT_EQUALS(index.line_start(2), index.line_end(2));    // Empty line
+    UTEST_ASSERT_EQUALS(source.length(), index.line_end(3));
+
+    LinePosition pos = index.position(source.find('+'));
+    UTEST_ASSERT_EQUALS(1u, pos.line);
+    UTEST_ASSERT_EQUALS(13u, pos.column);
+    pos = index.position(source.find(u8"界") + 1);                  // Inside a multi-byte character
+    UTEST_ASSERT_EQUALS(1u, pos.line);
+    UTEST_ASSERT_EQUALS(10u, pos.column);
+    pos = index.position(source.length());
+    UTEST_ASSERT_EQUALS(3u, pos.line);
+    UTEST_ASSERT_EQUALS(3u, pos.column);
+    UTEST_ASSERT_EQUALS(1u, index.line_of(source.find('\r')));
+
+    bool line_start_exception = false;
+    bool line_end_exception = false;
+    bool position_exception = false;
+    try { index.line_start(4); } catch (const std::out_of_range&) { line_start_exception = true; }
+    try { index.line_end(4); } catch (const std::out_of_range&) { line_end_exception = true; }
+    try { index.position(source.length() + 1); } catch (const std::out_of_range&) { position_exception = true; }
+    UTEST_ASSERT_TRUE(line_start_exception);
+    UTEST_ASSERT_TRUE(line_end_exception);
+    UTEST_ASSERT_TRUE(position_exception);
+
+    // Empty input, trailing newline, lone CR and BOM
+    std::string empty_str;
+    LineIndex empty(empty_str);
+    UTEST_ASSERT_EQUALS(1u, empty.line_count());
+    UTEST_ASSERT_EQUALS(0u, empty.position(0).column);
+    std::string trailing_newline = "a\n";
+    std::string lone_cr = "a\rb";
+    UTEST_ASSERT_EQUALS(2u, LineIndex(trailing_newline).line_count());
+    UTEST_ASSERT_EQUALS(1u, LineIndex(lone_cr).line_count());
+
+    std::string with_bom = bom_str() + u8"é=1\nx";
+    LineIndex bom_index(with_bom);
+    UTEST_ASSERT_EQUALS(0u, bom_index.position(0).column);
+    UTEST_ASSERT_EQUALS(0u, bom_index.position(2).column);
+    UTEST_ASSERT_EQUALS(0u, bom_index.position(3).column);
+    UTEST_ASSERT_EQUALS(1u, bom_index.position(with_bom.find('=')).column);
+    UTEST_ASSERT_EQUALS(0u, bom_index.position(with_bom.find('x')).column);
+
+    // Each invalid byte is a column, as in make_char_range()
+    std::string invalid_str = "a\x80\x80" "b";
+    LineIndex invalid(invalid_str);
+    UTEST_ASSERT_EQUALS(1u, invalid.position(1).column);
+    UTEST_ASSERT_EQUALS(2u, invalid.position(2).column);
+    UTEST_ASSERT_EQUALS(3u, invalid.position(3).column);
+    std::string truncated = "a\xE4" "b";
+    std::string overlong = "a\xC1\x81" "b";
+    UTEST_ASSERT_EQUALS(2u, LineIndex(truncated).position(2).column);
+    UTEST_ASSERT_EQUALS(1u, LineIndex(overlong).position(2).column);   // Decoded as one character
+    UTEST_ASSERT_EQUALS(2u, LineIndex(overlong).position(3).column);
+
+    // Pointer and length constructor over part of a buffer
+    LineIndex prefix(source.data(), 12);
+    UTEST_ASSERT_EQUALS(2u, prefix.line_count());
+    UTEST_ASSERT_EQUALS(12u, prefix.line_end(1));
+    UTEST_ASSERT_EQUALS(1u, prefix.position(12).column);
+}
+
+// Test every offset against a rescan from the start, for long lines, invalid bytes and every block alignment
+UTEST_FUNC_DEF2(U8ScanAnalysis, LineIndexMatchesRescan) {
+    std::string chunk = std::string(u8"Ünïcödé tëxt, 世界 and emoji 🌍🚀 over more than one block\n") +
+                        "\n" + std::string(37, '-') + "\r\n" + u8"日本語\n" + std::string(64, 'x') + "\n" +
+                        "a\x80\x80" "b \xE4" "b \xC1\x81 \xF0\x9F\x8C\n\xE4\xB8\n\xFF" + u8"界" + std::string(30, '.') + "\xDF\n";
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        std::string text = std::string(offset, 'a') + "\n" + chunk + std::string(offset % 7, 'z');
+        if (offset % 5 == 0) {
+            text = bom_str() + text;
+        }
+        LineIndex index(text);
+
+        // Line and column of the character at each offset, from the iterator
+        std::vector<LinePosition> expected(text.length() + 1);
+        std::vector<std::size_t> starts(1, 0);
+        LinePosition current = {0, 0};
+        for (const auto& info : make_char_range(text)) {
+            for (std::size_t i = 0; i < info.byte_count; ++i) {
+                expected[info.start_pos + i] = current;
+            }
+            if (info.codepoint == '\n') {
+                ++current.line;
+                current.column = 0;
+                starts.push_back(info.start_pos + 1);
+            } else {
+                ++current.column;
+            }
+        }
+        expected[text.length()] = current;
+        std::size_t bom = offset % 5 == 0 ? 3 : 0;
+        for (std::size_t i = 0; i < bom; ++i) {
+            expected[i] = LinePosition{0, 0};
+        }
+
+        UTEST_ASSERT_EQUALS(current.line + 1, index.line_count());
+        for (std::size_t i = 0; i <= text.length(); ++i) {
+            LinePosition pos = index.position(i);
+            UTEST_ASSERT_EQUALS(expected[i].line, pos.line);
+            UTEST_ASSERT_EQUALS(expected[i].column, pos.column);
+            UTEST_ASSERT_EQUALS(starts[pos.line], index.line_start(pos.line));
+        }
+    }
+}
+
+// Main test runner
+int main() {
+    UTEST_PROLOG();
+    UTEST_ENABLE_VERBOSE_MODE();
+
+    // Text statistics tests
+    UTEST_FUNC2(U8ScanAnalysis, Counts);
+    UTEST_FUNC2(U8ScanAnalysis, MatchesIteratorCounts);
+
+    // Script tests
+    UTEST_FUNC2(U8ScanAnalysis, Scripts);
+    UTEST_FUNC2(U8ScanAnalysis, ScriptHistogram);
+
+    // Line index tests
+    UTEST_FUNC2(U8ScanAnalysis, LineIndex);
+    UTEST_FUNC2(U8ScanAnalysis, LineIndexMatchesRescan);
+
+    UTEST_EPILOG();
+}
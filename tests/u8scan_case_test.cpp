@@ -0,0 +1,205 @@
+#include "../include/utest/utest.h"
+#include "../include/u8scan/u8scan.h"
+#include <cctype>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace u8scan;
+
+// Test simple case mappings of code points across scripts
+UTEST_FUNC_DEF2(U8ScanCase, CodepointMappings) {
+    // ASCII and Latin-1
+    UTEST_ASSERT_EQUALS(static_cast<uint32_t>('a'), simple_lowercase('A'));
+    UTEST_ASSERT_EQUALS(static_cast<uint32_t>('Z'), simple_uppercase('z'));
+    UTEST_ASSERT_EQUALS(static_cast<uint32_t>('1'), simple_lowercase('1'));
+    UTEST_ASSERT_EQUALS(0xE0u, simple_lowercase(0xC0));      // À -> à
+    UTEST_ASSERT_EQUALS(0x178u, simple_uppercase(0xFF));     // ÿ -> Ÿ
+
+    // Mappings without a counterpart in the other direction
+    UTEST_ASSERT_EQUALS(0xDFu, simple_uppercase(0xDF));      // ß has no simple uppercase
+    UTEST_ASSERT_EQUALS(0xDFu, simple_lowercase(0x1E9E));    // ẞ -> ß
+    UTEST_ASSERT_EQUALS(0x69u, simple_lowercase(0x130));     // İ -> i
+    UTEST_ASSERT_EQUALS(0x49u, simple_uppercase(0x131));     // ı -> I
+    UTEST_ASSERT_EQUALS(0x53u, simple_uppercase(0x17F));     // ſ -> S
+
+    // Greek, Cyrillic, Armenian, Georgian, Cherokee
+    UTEST_ASSERT_EQUALS(0x3C3u, simple_lowercase(0x3A3));    // Σ -> σ
+    UTEST_ASSERT_EQUALS(0x3A3u, simple_uppercase(0x3C2));    // ς -> Σ
+    UTEST_ASSERT_EQUALS(0x43Fu, simple_lowercase(0x41F));    // П -> п
+    UTEST_ASSERT_EQUALS(0x531u, simple_uppercase(0x561));    // ա -> Ա
+    UTEST_ASSERT_EQUALS(0x10D0u, simple_lowercase(0x1C90));  // Მ -> ა
+    UTEST_ASSERT_EQUALS(0xAB70u, simple_lowercase(0x13A0));  // Ꭰ -> ꭰ
+
+    // Supplementary planes
+    UTEST_ASSERT_EQUALS(0x10428u, simple_lowercase(0x10400)); // Deseret
+    UTEST_ASSERT_EQUALS(0x1E900u, simple_uppercase(0x1E922)); // Adlam
+
+    // No case
+    UTEST_ASSERT_EQUALS(0x4E16u, simple_lowercase(0x4E16));
+    UTEST_ASSERT_EQUALS(0x1F30Du, simple_uppercase(0x1F30D));
+    UTEST_ASSERT_EQUALS(0x10FFFFu, simple_lowercase(0x10FFFF));
+    UTEST_ASSERT_EQUALS(0x110000u, simple_lowercase(0x110000));
+}
+
+// Test CharInfo-based conversion
+UTEST_FUNC_DEF2(U8ScanCase, CharInfoMappings) {
+    std::string text = u8"AÉσ世";
+    auto range = make_char_range(text);
+    std::vector<uint32_t> lower, upper;
+    for (const auto& info : range) {
+        lower.push_back(to_lower(info));
+        upper.push_back(to_upper(info));
+    }
+    UTEST_ASSERT_EQUALS(4u, lower.size());
+    UTEST_ASSERT_EQUALS(0x61u, lower[0]);
+    UTEST_ASSERT_EQUALS(0xE9u, lower[1]);
+    UTEST_ASSERT_EQUALS(0x3A3u, upper[2]);
+    UTEST_ASSERT_EQUALS(0x4E16u, upper[3]);
+
+    // Invalid bytes and bytes read in ASCII mode are not treated as code points
+    std::string invalid = "\xC0";
+    UTEST_ASSERT_EQUALS(0xC0u, to_lower(get_char_info(invalid, 0)));
+    auto ascii_range = make_char_range(invalid, false);
+    UTEST_ASSERT_EQUALS(0xC0u, to_lower(*ascii_range.begin()));
+
+    // Usable as a pipeline map stage
+    std::string mapped = pipeline().map([](const CharInfo& info) { return to_upper(info); }).run(u8"straße σ");
+    UTEST_ASSERT_STR_EQUALS(u8"STRAßE Σ", mapped.c_str());
+}
+
+// Test whole-string conversion
+UTEST_FUNC_DEF2(U8ScanCase, StringConversion) {
+    // Simple mappings are context free, final sigma is not handled
+    UTEST_ASSERT_STR_EQUALS(u8"àéî σασ привет ա 世界 🌍", to_lower_str(u8"ÀÉÎ ΣΑΣ ПРИВЕТ Ա 世界 🌍").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"ÀÉÎ ΣΑΣ ПРИВЕТ Ա 世界 🌍", to_upper_str(u8"àéî σας привет ա 世界 🌍").c_str());
+    UTEST_ASSERT_STR_EQUALS("", to_lower_str("").c_str());
+
+    // Byte length may change while the character count does not
+    std::string grows = u8"ȺȾ";
+    std::string lower = to_lower_str(grows);
+    UTEST_ASSERT_STR_EQUALS(u8"ⱥⱦ", lower.c_str());
+    UTEST_ASSERT_EQUALS(4u, grows.length());
+    UTEST_ASSERT_EQUALS(6u, lower.length());
+    UTEST_ASSERT_STR_EQUALS(grows.c_str(), to_upper_str(lower).c_str());
+
+    // Invalid bytes and BOM are copied unchanged
+    std::string invalid = bom_str() + "AB\xC0\xFF" + u8"Ç\xE4\xB8";
+    std::string expected = bom_str() + "ab\xC0\xFF" + u8"ç\xE4\xB8";
+    UTEST_ASSERT_TRUE(to_lower_str(invalid) == expected);
+
+    // Overlong forms and encoded surrogates are ill-formed, not letters to convert
+    UTEST_ASSERT_TRUE(to_lower_str("\xC1\x81" "B") == "\xC1\x81" "b");
+    UTEST_ASSERT_TRUE(to_upper_str("\xC1\xA1\xE0\x81\xA1") == "\xC1\xA1\xE0\x81\xA1");
+    UTEST_ASSERT_TRUE(to_upper_str("\xED\xA0\x80" "a") == "\xED\xA0\x80" "A");
+
+    // Long ASCII runs mixed with other scripts at every offset
+    std::string text = u8"The Quick Brown Fox Jumps Over Ωmega ДОМ ";
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        std::string input = std::string(offset, 'X') + text + text;
+        std::string expected_lower = std::string(offset, 'x') + u8"the quick brown fox jumps over ωmega дом the quick brown fox jumps over ωmega дом ";
+        UTEST_ASSERT_STR_EQUALS(expected_lower.c_str(), to_lower_str(input).c_str());
+    }
+}
+
+// Test full case folding of code points and strings
+UTEST_FUNC_DEF2(U8ScanCase, Casefold) {
+    UTEST_ASSERT_EQUALS(0x3C3u, simple_casefold(0x3C2));     // ς -> σ
+    UTEST_ASSERT_EQUALS(0x6Bu, simple_casefold(0x212A));     // Kelvin sign -> k
+    UTEST_ASSERT_EQUALS(0xDFu, simple_casefold(0xDF));       // ß has only a full folding
+    UTEST_ASSERT_EQUALS(0x13A0u, simple_casefold(0xAB70));   // Cherokee folds to uppercase
+
+    uint32_t folded[3];
+    UTEST_ASSERT_EQUALS(2u, casefold(0xDF, folded));
+    UTEST_ASSERT_EQUALS(0x73u, folded[0]);
+    UTEST_ASSERT_EQUALS(0x73u, folded[1]);
+    UTEST_ASSERT_EQUALS(3u, casefold(0x390, folded));        // ΐ
+    UTEST_ASSERT_EQUALS(1u, casefold('A', folded));
+    UTEST_ASSERT_EQUALS(0x61u, folded[0]);
+
+    UTEST_ASSERT_STR_EQUALS(u8"strasse σσσ ǆ 世界", casefold_str(u8"Straße ΣσΣ ǅ 世界").c_str());
+    std::string invalid = bom_str() + "AB\xC0" + u8"ẞ";
+    UTEST_ASSERT_TRUE(casefold_str(invalid) == "ab\xC0" "ss");
+    UTEST_ASSERT_TRUE(casefold_str("\xC1\x81\xED\xA0\x80") == "\xC1\x81\xED\xA0\x80");   // Overlong 'A', surrogate
+}
+
+// Test case-insensitive comparison, equality and hashing
+UTEST_FUNC_DEF2(U8ScanCase, CasefoldCompare) {
+    UTEST_ASSERT_TRUE(casefold_equal(u8"Straße", u8"STRASSE"));
+    UTEST_ASSERT_TRUE(casefold_equal(u8"ΣΊΣΥΦΟΣ", u8"σίσυφος"));
+    UTEST_ASSERT_TRUE(casefold_equal("Kelvin", u8"Kelvin"));
+    UTEST_ASSERT_TRUE(casefold_equal("", bom_str()));
+    UTEST_ASSERT_TRUE(casefold_equal(bom_str() + "ABC", "abc"));
+    UTEST_ASSERT_FALSE(casefold_equal("abc", "abcd"));
+    UTEST_ASSERT_FALSE(casefold_equal(u8"i", u8"ı"));
+
+    UTEST_ASSERT_TRUE(casefold_compare("apple", "Banana") < 0);
+    UTEST_ASSERT_TRUE(casefold_compare("APPLE", "banana") < 0);
+    UTEST_ASSERT_TRUE(casefold_compare("Zeta", "alpha") > 0);
+    UTEST_ASSERT_TRUE(casefold_compare("abc", "ABCD") < 0);
+    UTEST_ASSERT_TRUE(casefold_compare(u8"ß", "sr") > 0);     // "ss" > "sr"
+    UTEST_ASSERT_TRUE(casefold_compare(u8"ß", "st") < 0);
+
+    // Invalid bytes only match themselves and sort after all code points
+    UTEST_ASSERT_TRUE(casefold_equal("A\xFF", "a\xFF"));
+    UTEST_ASSERT_FALSE(casefold_equal("\xC3", u8"Ã"));
+    UTEST_ASSERT_TRUE(casefold_compare("\xFF", u8"\U0010FFFF") > 0);
+    UTEST_ASSERT_FALSE(casefold_equal("\xC1\x81", "a"));                 // Overlong 'A'
+    UTEST_ASSERT_TRUE(casefold_equal("\xC1\x81" "B", "\xC1\x81" "b"));
+
+    // Hash is consistent with equality
+    UTEST_ASSERT_EQUALS(casefold_hash(u8"Straße"), casefold_hash(u8"STRASSE"));
+    UTEST_ASSERT_EQUALS(casefold_hash(bom_str() + "Kelvin"), casefold_hash(u8"KELVIN"));
+    UTEST_ASSERT_TRUE(casefold_hash("abc") != casefold_hash("abd"));
+
+    std::unordered_set<std::string, CasefoldHash, CasefoldEqual> users;
+    users.insert(u8"Jürgen");
+    users.insert(u8"JÜRGEN");
+    UTEST_ASSERT_EQUALS(1u, users.size());
+    UTEST_ASSERT_EQUALS(1u, users.count(u8"jürgen"));
+}
+
+// Test that the 16-byte ASCII blocks agree with folding one code point at a time
+UTEST_FUNC_DEF2(U8ScanCase, CasefoldBlocks) {
+    std::string text = "The Quick Brown Fox Jumps Over The Lazy Dog [@`{] 0123456789 ";
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        std::string a = std::string(offset, 'x') + text + text;
+        std::string b = std::string(offset, 'X') + to_upper_ascii_str(text) + to_lower_ascii_str(text);
+        UTEST_ASSERT_EQUALS(0, casefold_compare(a, b));
+        UTEST_ASSERT_EQUALS(casefold_hash(a), casefold_hash(b));
+        UTEST_ASSERT_EQUALS(casefold_hash(u8"ẞ" + a), casefold_hash("ss" + b));
+
+        // Difference at every position, including characters between the two letter ranges
+        for (std::size_t i = 0; i < a.length(); i += 7) {
+            std::string c = b;
+            c[i] = '[';
+            int folded = std::tolower(static_cast<unsigned char>(a[i]));
+            int expected = folded < '[' ? -1 : (folded == '[' ? 0 : 1);
+            int result = casefold_compare(a, c);
+            UTEST_ASSERT_EQUALS(expected, result < 0 ? -1 : (result > 0 ? 1 : 0));
+        }
+
+        // Multi-byte characters after the ASCII prefix
+        UTEST_ASSERT_TRUE(casefold_equal(a + u8"Straße", b + u8"STRASSE"));
+        UTEST_ASSERT_TRUE(casefold_compare(a + u8"é", b + u8"É") == 0);
+        UTEST_ASSERT_TRUE(casefold_compare(a + u8"é", b + "f") > 0);
+    }
+}
+
+// Main test runner
+int main() {
+    UTEST_PROLOG();
+    UTEST_ENABLE_VERBOSE_MODE();
+
+    // Case mapping tests
+    UTEST_FUNC2(U8ScanCase, CodepointMappings);
+    UTEST_FUNC2(U8ScanCase, CharInfoMappings);
+    UTEST_FUNC2(U8ScanCase, StringConversion);
+
+    // Case folding tests
+    UTEST_FUNC2(U8ScanCase, Casefold);
+    UTEST_FUNC2(U8ScanCase, CasefoldCompare);
+    UTEST_FUNC2(U8ScanCase, CasefoldBlocks);
+
+    UTEST_EPILOG();
+}
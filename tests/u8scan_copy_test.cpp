@@ -271,6 +271,47 @@ UTEST_FUNC_DEF2(CopyFunctions, STLIntegration) {
     UTEST_ASSERT_STR_EQUALS(no_emojis.c_str(), "Hello123世界Test456你好End!");
 }
 
+// Test run copying into strings, raw buffers and generic iterators
+UTEST_FUNC_DEF2(CopyFunctions, OutputTargets) {
+    std::string input = u8"ab世界🌍cd 123 ü";
+    input += "\xFF\xE4\xB8";  // Invalid lead byte and truncated sequence are copied unchanged
+    input += "end";
+
+    std::string expected_utf8;
+    u8scan::copy_if(input, std::back_inserter(expected_utf8), predicates::is_utf8());
+
+    // Raw char buffer
+    char buffer[64];
+    char* buffer_end = u8scan::copy(input, buffer);
+    UTEST_ASSERT_EQUALS(input.length(), static_cast<std::size_t>(buffer_end - buffer));
+    UTEST_ASSERT_TRUE(std::string(buffer, buffer_end) == input);
+
+    buffer_end = u8scan::copy_if(input, buffer, predicates::is_utf8());
+    UTEST_ASSERT_TRUE(std::string(buffer, buffer_end) == expected_utf8);
+
+    // Generic output iterator
+    std::vector<char> chars;
+    u8scan::copy_if(input, std::back_inserter(chars), predicates::is_utf8());
+    UTEST_ASSERT_TRUE(std::string(chars.begin(), chars.end()) == expected_utf8);
+
+    // Appending to a string keeps existing content
+    std::string appended = "prefix:";
+    u8scan::copy_until(input, std::back_inserter(appended), predicates::is_whitespace_ascii());
+    UTEST_ASSERT_STR_EQUALS(u8"prefix:ab世界🌍cd", appended.c_str());
+
+    // Alternating matches produce separate runs
+    std::string letters;
+    u8scan::copy_if(std::string(u8"a1b2世3c"), std::back_inserter(letters), predicates::is_alpha_ascii());
+    UTEST_ASSERT_STR_EQUALS("abc", letters.c_str());
+
+    // Returned iterator points past the written bytes
+    char small[16];
+    char* end_n = u8scan::copy_n(bom_str() + u8"世界abc", small, 3);
+    UTEST_ASSERT_TRUE(std::string(small, end_n) == u8"世界a");
+    char* end_from = u8scan::copy_from(std::string("abc"), small, predicates::is_digit_ascii());
+    UTEST_ASSERT_TRUE(end_from == small);
+}
+
 int main() {
     UTEST_PROLOG();
     UTEST_ENABLE_VERBOSE_MODE();
@@ -284,6 +325,7 @@ int main() {
     UTEST_FUNC2(CopyFunctions, CopyWhile);
     UTEST_FUNC2(CopyFunctions, EdgeCases);
     UTEST_FUNC2(CopyFunctions, STLIntegration);
+    UTEST_FUNC2(CopyFunctions, OutputTargets);
     
     UTEST_EPILOG();
 }
@@ -1,10 +1,21 @@
 #include "../include/utest/utest.h"
 #include "../include/u8scan/u8scan.h"
+#include <algorithm>
 #include <vector>
 #include <string>
 
 using namespace u8scan;
 
+namespace {
+
+// UTF-8 encoding of a code point
+std::string encode(uint32_t cp) {
+    char buffer[4];
+    return std::string(buffer, details::encode_utf8(cp, buffer));
+}
+
+} // namespace
+
 // Test the is_emoji predicate with various emoji categories
 UTEST_FUNC_DEF2(U8ScanEmoji, BasicEmojiDetection) {
     // Test basic emoji detection
@@ -254,6 +265,67 @@ UTEST_FUNC_DEF2(U8ScanEmoji, EdgeCases) {
     UTEST_ASSERT_EQUALS(2, mixed_emoji_count);
 }
 
+// Test code points at the edges of the emoji properties
+UTEST_FUNC_DEF2(U8ScanEmoji, EmojiProperties) {
+    struct Case { uint32_t cp; bool expected; };
+    std::vector<Case> cases = {
+        {'#', false}, {'*', false}, {'0', false}, {0x00A9, false}, {0x00AE, false}, {0x2122, false},
+        {0x203C, true}, {0x2049, true}, {0x2139, true}, {0x2600, true}, {0x2605, true}, {0x2606, false},
+        {0x2705, true}, {0x2B50, true}, {0x3030, true}, {0x1F004, true}, {0x2193, false}, {0x2194, true}, {0x1F1E6, true},
+        {0x1F3FB, true}, {0x1F3FF, true}, {0x1FAF6, true}, {0x1FFFD, true}, {0x1FFFE, false},
+        {0xFE0F, false}, {0x200D, false}, {0x20E3, false}, {0xE0067, false}, {0x10FFFF, false},
+    };
+    for (const auto& c : cases) {
+        CharInfo info = front(encode(c.cp));
+        UTEST_ASSERT_EQUALS(c.expected, predicates::is_emoji()(info));
+    }
+}
+
+// Test that count_emoji() agrees with counting by predicate
+UTEST_FUNC_DEF2(U8ScanEmoji, CountEmoji) {
+    UTEST_ASSERT_EQUALS(0u, count_emoji(""));
+    UTEST_ASSERT_EQUALS(0u, count_emoji("Hello World 123!"));
+    UTEST_ASSERT_EQUALS(2u, count_emoji("Hello 🌍 World 123 🚀 Test!"));
+    UTEST_ASSERT_EQUALS(2u, count_emoji("🇺🇸"));
+    UTEST_ASSERT_EQUALS(3u, count_emoji("👩‍💻 ❤️ © ™"));  // Woman, laptop and heart
+    UTEST_ASSERT_EQUALS(1u, count_emoji(bom_str() + "🌍"));
+
+    // Every code point once
+    std::string all;
+    for (uint32_t cp = 0; cp < 0x110000; ++cp) {
+        if (cp < 0xD800 || cp > 0xDFFF) {
+            all += encode(cp);
+        }
+    }
+    auto all_range = make_char_range(all);
+    std::size_t expected = static_cast<std::size_t>(std::count_if(all_range.begin(), all_range.end(), predicates::is_emoji()));
+    UTEST_ASSERT_EQUALS(expected, count_emoji(all));
+    UTEST_ASSERT_TRUE(expected > 3000);
+
+    // Emoji and invalid bytes at every block offset
+    std::string text = std::string("Plain ASCII text long enough to span a few SIMD blocks \xF0\x9F\x8C ") + "世界 🚀\xFF";
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        std::string input = text.substr(0, offset) + "☕" + text + "\xE2\x98" + text.substr(offset);
+        auto range = make_char_range(input);
+        UTEST_ASSERT_EQUALS(static_cast<std::size_t>(std::count_if(range.begin(), range.end(), predicates::is_emoji())),
+                            count_emoji(input));
+    }
+    // Ill-formed input is counted as the character iterator decodes it: a 4-byte overlong form of
+    // U+2764, an encoded surrogate, an F5 lead and truncated sequences
+    std::vector<std::string> ill_formed = {
+        "\xF0\x82\x9D\xA4", "\xE0\x9F\x8C\x8D", "\xED\xA0\xBD\xED\xBC\x8D", "\xF5\x80\x80\x80",
+        "\xF0\x9F\x8C", "\xC1\x81", "\xE2\x98\x95\x80",
+    };
+    for (const auto& fragment : ill_formed) {
+        for (std::size_t offset = 0; offset < 20; ++offset) {
+            std::string input = std::string(offset, 'x') + fragment + u8"☕" + fragment;
+            auto range = make_char_range(input);
+            UTEST_ASSERT_EQUALS(static_cast<std::size_t>(std::count_if(range.begin(), range.end(), predicates::is_emoji())),
+                                count_emoji(input));
+        }
+    }
+}
+
 // Run all emoji tests
 int main() {
     UTEST_PROLOG();
@@ -271,6 +343,10 @@ int main() {
     UTEST_FUNC2(U8ScanEmoji, MiscellaneousSymbols);
     UTEST_FUNC2(U8ScanEmoji, SpecificEmojiRanges);
     UTEST_FUNC2(U8ScanEmoji, EdgeCases);
+    UTEST_FUNC2(U8ScanEmoji, EmojiProperties);
+
+    // Bulk counting tests
+    UTEST_FUNC2(U8ScanEmoji, CountEmoji);
     
     UTEST_EPILOG();
 }
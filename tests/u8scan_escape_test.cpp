@@ -0,0 +1,211 @@
+#include "../include/utest/utest.h"
+#include "../include/u8scan/u8scan.h"
+#include <string>
+#include <vector>
+
+using namespace u8scan;
+
+namespace {
+
+// Character-by-character quoting, used as reference for the vectorized implementation
+std::string reference_quoted(const std::string& input, char start_delim, char end_delim, char escape) {
+    std::string result(1, start_delim);
+    auto range = make_char_range(input);
+    for (const auto& info : range) {
+        if (info.is_ascii) {
+            char c = static_cast<char>(info.codepoint);
+            if (c == start_delim || c == end_delim || c == escape) result += escape;
+            result += c;
+        } else {
+            result.append(input, info.start_pos, info.byte_count);
+        }
+    }
+    return result + end_delim;
+}
+
+} // namespace
+
+// Test quoting with default and custom delimiters
+UTEST_FUNC_DEF2(U8ScanEscape, QuotedStr) {
+    UTEST_ASSERT_STR_EQUALS(u8"\"A\\\"B世界\"", quoted_str(u8"A\"B世界").c_str());
+    UTEST_ASSERT_STR_EQUALS("\"\"", quoted_str("").c_str());
+    UTEST_ASSERT_STR_EQUALS("\"\\\\\"", quoted_str("\\").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"[a\\[b\\]c\\\\ 🌍]", quoted_str(u8"a[b]c\\ 🌍", '[', ']', '\\').c_str());
+    UTEST_ASSERT_STR_EQUALS("'it''s'", quoted_str("it's", '\'', '\'', '\'').c_str());
+
+    // BOM is not copied
+    UTEST_ASSERT_STR_EQUALS("\"Hello\"", quoted_str(bom_str() + "Hello").c_str());
+}
+
+// Test quoting against the reference for special characters at every block offset
+UTEST_FUNC_DEF2(U8ScanEscape, QuotedStrMatchesReference) {
+    std::string text = u8"Plain text with 世界 and emoji 🌍 long enough to span several SIMD blocks. ";
+    for (std::size_t offset = 0; offset < 80; ++offset) {
+        std::string input = text.substr(0, offset) + "\"\\<>" + text + text.substr(offset % 30) + "\\";
+        UTEST_ASSERT_STR_EQUALS(reference_quoted(input, '"', '"', '\\').c_str(), quoted_str(input).c_str());
+        UTEST_ASSERT_STR_EQUALS(reference_quoted(input, '<', '>', '/').c_str(), quoted_str(input, '<', '>', '/').c_str());
+
+        // Non-ASCII delimiters and escapes never match bytes inside multi-byte characters
+        UTEST_ASSERT_TRUE(reference_quoted(input, '\xE4', '\xB8', '\\') == quoted_str(input, '\xE4', '\xB8', '\\'));
+        UTEST_ASSERT_TRUE(reference_quoted(input, '"', '"', '\x96') == quoted_str(input, '"', '"', '\x96'));
+    }
+}
+
+// Test unquoting and round trips
+UTEST_FUNC_DEF2(U8ScanEscape, UnquotedStr) {
+    UTEST_ASSERT_STR_EQUALS(u8"A\"B世界", unquoted_str(u8"\"A\\\"B世界\"").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"a[b]c\\ 🌍", unquoted_str(u8"[a\\[b\\]c\\\\ 🌍]", '[', ']', '\\').c_str());
+    UTEST_ASSERT_STR_EQUALS("it's", unquoted_str("'it''s'", '\'', '\'', '\'').c_str());
+    UTEST_ASSERT_STR_EQUALS("", unquoted_str("\"\"").c_str());
+    UTEST_ASSERT_STR_EQUALS("", unquoted_str("").c_str());
+
+    // Content ends at the first unescaped end delimiter
+    UTEST_ASSERT_STR_EQUALS("first", unquoted_str("\"first\" \"second\"").c_str());
+    UTEST_ASSERT_STR_EQUALS("it", unquoted_str("'it' ''", '\'', '\'', '\'').c_str());
+
+    // Missing delimiters are tolerated
+    UTEST_ASSERT_STR_EQUALS(u8"no quotes 世界", unquoted_str(u8"no quotes 世界").c_str());
+    UTEST_ASSERT_STR_EQUALS("unterminated", unquoted_str("\"unterminated").c_str());
+
+    // Escape before an ordinary character is dropped, trailing escape is kept
+    UTEST_ASSERT_STR_EQUALS("abc", unquoted_str("\"a\\bc\"").c_str());
+    UTEST_ASSERT_STR_EQUALS("abc\\", unquoted_str("\"abc\\").c_str());
+
+    // Only ASCII delimiters and escapes are recognized, bytes of 世 (E4 B8 96) are kept
+    UTEST_ASSERT_STR_EQUALS(u8"a世b", unquoted_str(u8"a世b", '\xE4', '\xB8', '\x96').c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"世\"", unquoted_str(u8"\"世\\\"\"", '"', '"', '\\').c_str());
+    UTEST_ASSERT_TRUE(unquoted_str(u8"世界x", '\xE4', 'x', '\xB8') == u8"世界");
+
+    // Round trips
+    std::vector<std::string> samples = {
+        "", "plain", u8"Hello \"世界\"!", "\\\\\\\"", u8"🌍\"🚀\\", std::string(100, '"') + u8"ü" + std::string(50, '\\')
+    };
+    for (const auto& sample : samples) {
+        UTEST_ASSERT_STR_EQUALS(sample.c_str(), unquoted_str(quoted_str(sample)).c_str());
+        UTEST_ASSERT_STR_EQUALS(sample.c_str(), unquoted_str(quoted_str(sample, '\'', '\'', '\''), '\'', '\'', '\'').c_str());
+        UTEST_ASSERT_STR_EQUALS(sample.c_str(), unquoted_str(quoted_str(sample, '<', '>', '"'), '<', '>', '"').c_str());
+    }
+}
+
+// Test JSON escaping of special and control characters
+UTEST_FUNC_DEF2(U8ScanEscape, JsonEscape) {
+    UTEST_ASSERT_STR_EQUALS("", json_escape("").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"plain 世界 🌍", json_escape(u8"plain 世界 🌍").c_str());
+    UTEST_ASSERT_STR_EQUALS("\\\"q\\\" \\\\ /", json_escape("\"q\" \\ /").c_str());
+    UTEST_ASSERT_STR_EQUALS("\\b\\f\\n\\r\\t", json_escape("\b\f\n\r\t").c_str());
+    UTEST_ASSERT_STR_EQUALS("\\u0000\\u0001\\u001f\x7f", json_escape(std::string("\0\x01\x1f\x7f", 4)).c_str());
+
+    // Non-ASCII as \uXXXX, with surrogate pairs above U+FFFF
+    UTEST_ASSERT_STR_EQUALS("caf\\u00e9 \\u4e16 \\ud83c\\udf0d", json_escape(u8"café 世 🌍", true).c_str());
+    UTEST_ASSERT_STR_EQUALS("\\udbff\\udfff", json_escape(u8"\U0010FFFF", true).c_str());
+
+    // Ill-formed sequences become one U+FFFD each, only when non-ASCII is escaped
+    std::string invalid = std::string("a\xFF") + "b\xE4\xB8";
+    UTEST_ASSERT_STR_EQUALS("a\\ufffdb\\ufffd", json_escape(invalid, true).c_str());
+    UTEST_ASSERT_TRUE(json_escape(invalid) == invalid);
+
+    // Encoded surrogates and overlong forms are ill-formed, never a lone \ud800 or an escaped ASCII letter
+    UTEST_ASSERT_STR_EQUALS("\\ufffd\\ufffd\\ufffd", json_escape("\xED\xA0\x80", true).c_str());
+    UTEST_ASSERT_STR_EQUALS("\\ufffd\\ufffd", json_escape("\xC1\x81", true).c_str());
+    UTEST_ASSERT_STR_EQUALS("\\ufffd\\ufffd\\ufffdx", json_escape("\xE0\x80\x80x", true).c_str());
+    UTEST_ASSERT_STR_EQUALS("\\ufffd\\ufffd\\ufffd\\ufffd", json_escape("\xF4\x90\x80\x80", true).c_str());
+    std::string unescaped = json_unescape(json_escape("\xED\xA0\x80", true));
+    UTEST_ASSERT_STR_EQUALS(u8"\uFFFD\uFFFD\uFFFD", unescaped.c_str());
+
+    // BOM is not copied
+    UTEST_ASSERT_STR_EQUALS("x\\n", json_escape(bom_str() + "x\n").c_str());
+
+    // Specials at every block offset
+    std::string text = u8"Text with 世界 and 🌍, long enough to span several SIMD blocks. ";
+    for (std::size_t offset = 0; offset < 70; ++offset) {
+        std::string input = text.substr(0, offset) + "\"\n" + text + "\\";
+        std::string expected;
+        for (char c : input) {
+            if (c == '"') expected += "\\\"";
+            else if (c == '\\') expected += "\\\\";
+            else if (c == '\n') expected += "\\n";
+            else expected += c;
+        }
+        UTEST_ASSERT_STR_EQUALS(expected.c_str(), json_escape(input).c_str());
+    }
+}
+
+// Test JSON unescaping and round trips
+UTEST_FUNC_DEF2(U8ScanEscape, JsonUnescape) {
+    UTEST_ASSERT_STR_EQUALS("", json_unescape("").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"plain 世界", json_unescape(u8"plain 世界").c_str());
+    UTEST_ASSERT_STR_EQUALS("\"q\" \\ / \b\f\n\r\t", json_unescape("\\\"q\\\" \\\\ \\/ \\b\\f\\n\\r\\t").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"café 世 🌍", json_unescape("caf\\u00E9 \\u4e16 \\ud83c\\udf0d").c_str());
+    UTEST_ASSERT_TRUE(json_unescape("a\\u0000b") == std::string("a\0b", 3));
+
+    // Unpaired surrogates decode as U+FFFD
+    UTEST_ASSERT_STR_EQUALS(u8"�x", json_unescape("\\ud83cx").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"�", json_unescape("\\udf0d").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"�世", json_unescape("\\ud83c\\u4e16").c_str());
+
+    // Malformed escapes are copied unchanged
+    UTEST_ASSERT_STR_EQUALS("\\q \\u12 \\", json_unescape("\\q \\u12 \\").c_str());
+
+    // Round trips
+    std::vector<std::string> samples = {
+        "", u8"Hello \"世界\"!\n", std::string("\0\x1f\\/", 4), u8"🌍🚀 \U0010FFFF", std::string(40, '"') + u8"ü\t"
+    };
+    for (const auto& sample : samples) {
+        UTEST_ASSERT_TRUE(json_unescape(json_escape(sample)) == sample);
+        UTEST_ASSERT_TRUE(json_unescape(json_escape(sample, true)) == sample);
+    }
+}
+
+// Test U+FFFD substitution of ill-formed UTF-8 per maximal subpart
+UTEST_FUNC_DEF2(U8ScanEscape, SanitizeUTF8) {
+    const std::string fffd = "\xEF\xBF\xBD";
+    struct Case { std::string input; std::string expected; };
+    std::vector<Case> cases = {
+        {"", ""},
+        {u8"valid 世界 🌍", u8"valid 世界 🌍"},
+        {"a\xFF" "b", "a" + fffd + "b"},                             // Invalid lead byte
+        {"\x80\x80", fffd + fffd},                                    // Stray continuation bytes
+        {"\xC0\xAF", fffd + fffd},                                    // Overlong 2-byte form
+        {"\xE0\x80\xAF", fffd + fffd + fffd},                         // Overlong 3-byte form
+        {"\xED\xA0\x80", fffd + fffd + fffd},                         // Encoded surrogate
+        {"\xF4\x90\x80\x80", fffd + fffd + fffd + fffd},              // Above U+10FFFF
+        {"\xF0\x9F\x8C" "z", fffd + "z"},                             // Truncated 4-byte sequence
+        {"\xE4\xB8", fffd},                                           // Truncated at end of input
+        {"\xF1\x80\x80\xE1\x80\xC2", fffd + fffd + fffd},             // Consecutive maximal subparts
+        {bom_str() + "x", bom_str() + "x"},                           // BOM is kept
+    };
+    for (const auto& c : cases) {
+        UTEST_ASSERT_TRUE(sanitize_utf8(c.input) == c.expected);
+    }
+
+    // Valid input is returned as is
+    std::string buffer = "untouched";
+    std::string valid = std::string(100, 'a') + u8"世界";
+    UTEST_ASSERT_TRUE(&sanitize_utf8(valid, buffer) == &valid);
+    UTEST_ASSERT_STR_EQUALS("untouched", buffer.c_str());
+
+    // Invalid input is written to the buffer, replacing its content
+    std::string invalid = std::string(40, 'a') + "\xFF" + std::string(40, 'b');
+    UTEST_ASSERT_TRUE(&sanitize_utf8(invalid, buffer) == &buffer);
+    UTEST_ASSERT_TRUE(buffer == std::string(40, 'a') + fffd + std::string(40, 'b'));
+}
+
+// Main test runner
+int main() {
+    UTEST_PROLOG();
+    UTEST_ENABLE_VERBOSE_MODE();
+
+    // Quoting tests
+    UTEST_FUNC2(U8ScanEscape, QuotedStr);
+    UTEST_FUNC2(U8ScanEscape, QuotedStrMatchesReference);
+    UTEST_FUNC2(U8ScanEscape, UnquotedStr);
+
+    // JSON tests
+    UTEST_FUNC2(U8ScanEscape, JsonEscape);
+    UTEST_FUNC2(U8ScanEscape, JsonUnescape);
+
+    // Sanitizer tests
+    UTEST_FUNC2(U8ScanEscape, SanitizeUTF8);
+
+    UTEST_EPILOG();
+}
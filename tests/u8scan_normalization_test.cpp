@@ -0,0 +1,148 @@
+#include "../include/utest/utest.h"
+#include "../include/u8scan/u8scan.h"
+#include <string>
+#include <vector>
+
+using namespace u8scan;
+
+// Test the four normalization forms on characters with canonical and compatibility mappings
+UTEST_FUNC_DEF2(U8ScanNormalization, Forms) {
+    std::string decomposed = u8"é";                       // e + combining acute
+    UTEST_ASSERT_STR_EQUALS(u8"é", normalize(decomposed).c_str());
+    UTEST_ASSERT_STR_EQUALS(decomposed.c_str(), normalize(u8"é", NormalizationForm::NFD).c_str());
+
+    // Compatibility mappings are only applied by NFKC and NFKD
+    UTEST_ASSERT_STR_EQUALS(u8"ﬁ x²", normalize(u8"ﬁ x²").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"fi x2", normalize(u8"ﬁ x²", NormalizationForm::NFKC).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"Å", normalize(u8"Å", NormalizationForm::NFKD).c_str());
+
+    // Singletons and composition exclusions
+    UTEST_ASSERT_STR_EQUALS(u8"Å", normalize(u8"Å").c_str());             // Angstrom sign
+    UTEST_ASSERT_STR_EQUALS(u8"क़", normalize(u8"क़").c_str());       // Excluded from composition
+
+    // Canonical ordering of combining marks
+    UTEST_ASSERT_STR_EQUALS(u8"ậ", normalize(u8"ậ", NormalizationForm::NFD).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"ậ", normalize(u8"ậ").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"ḍ̇", normalize(u8"ḍ̇").c_str());   // Reordered, then composed
+    UTEST_ASSERT_STR_EQUALS(u8"ḍ̇", normalize(u8"ḍ̇").c_str());
+
+    // Hangul syllables are decomposed and composed algorithmically
+    UTEST_ASSERT_STR_EQUALS(u8"각", normalize(u8"각", NormalizationForm::NFD).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"각", normalize(u8"각").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"각", normalize(u8"각").c_str());
+
+    // Invalid bytes are copied and block composition
+    std::string invalid = std::string("e\xFF") + u8"́é\xE4\xB8";
+    UTEST_ASSERT_TRUE(normalize(invalid) == invalid);
+    UTEST_ASSERT_TRUE(normalize(invalid, NormalizationForm::NFD) == std::string("e\xFF") + u8"́é\xE4\xB8");
+}
+
+// Test the quick check fast path
+UTEST_FUNC_DEF2(U8ScanNormalization, QuickCheck) {
+    UTEST_ASSERT_TRUE(quick_check("plain ASCII") == QuickCheckResult::YES);
+    UTEST_ASSERT_TRUE(quick_check(u8"é世\U0001F30D") == QuickCheckResult::YES);
+    UTEST_ASSERT_TRUE(quick_check(u8"é", NormalizationForm::NFD) == QuickCheckResult::NO);
+    UTEST_ASSERT_TRUE(quick_check(u8"é") == QuickCheckResult::MAYBE);
+    UTEST_ASSERT_TRUE(quick_check(u8"क़") == QuickCheckResult::NO);
+    UTEST_ASSERT_TRUE(quick_check(u8"ậ", NormalizationForm::NFD) == QuickCheckResult::NO);
+    UTEST_ASSERT_TRUE(quick_check(u8"ﬁ") == QuickCheckResult::YES);
+    UTEST_ASSERT_TRUE(quick_check(u8"ﬁ", NormalizationForm::NFKC) == QuickCheckResult::NO);
+
+    UTEST_ASSERT_TRUE(is_normalized(u8"क́"));                // MAYBE that turns out normalized
+    UTEST_ASSERT_FALSE(is_normalized(u8"é"));
+    UTEST_ASSERT_TRUE(is_normalized(u8"é", NormalizationForm::NFD));
+
+    // Normalized input is returned as is and the buffer is not touched
+    std::string buffer = "untouched";
+    std::string text = std::string(100, 'a') + u8"é世";
+    UTEST_ASSERT_TRUE(&normalize(text, buffer) == &text);
+    UTEST_ASSERT_STR_EQUALS("untouched", buffer.c_str());
+
+    // Otherwise the result is written to the buffer, the prefix before the change is kept
+    std::string changed = std::string(100, 'a') + u8"Å" + std::string(100, 'b');
+    UTEST_ASSERT_TRUE(&normalize(changed, buffer) == &buffer);
+    UTEST_ASSERT_TRUE(buffer == std::string(100, 'a') + u8"Å" + std::string(100, 'b'));
+
+    // A combining mark after an ASCII run composes with its last character
+    std::string tail = std::string(40, 'x') + u8"é";
+    UTEST_ASSERT_TRUE(normalize(tail) == std::string(40, 'x') + u8"é");
+}
+
+// Test that chunked normalization matches normalizing the whole string
+UTEST_FUNC_DEF2(U8ScanNormalization, Streaming) {
+    std::vector<std::string> samples = {
+        "",
+        std::string(50, 'a'),
+        u8"Café Å 각 ḍ̇ ﬁ \U0001F30D " + std::string(30, 'z') + u8"é",
+        u8"́̂ leading marks",
+        std::string("bad \xFF\xE4\xB8") + u8" é",
+        u8"각가" + std::string(20, 'q') + u8"क़क़",
+    };
+    NormalizationForm forms[] = {NormalizationForm::NFC, NormalizationForm::NFD, NormalizationForm::NFKC, NormalizationForm::NFKD};
+    for (const auto& sample : samples) {
+        for (NormalizationForm form : forms) {
+            std::string expected = normalize(sample, form);
+            for (std::size_t chunk_size = 1; chunk_size <= 8; ++chunk_size) {
+                Normalizer normalizer(form);
+                std::string out;
+                for (std::size_t pos = 0; pos < sample.length(); pos += chunk_size) {
+                    normalizer.append(sample.substr(pos, chunk_size), out);
+                }
+                normalizer.finish(out);
+                UTEST_ASSERT_TRUE(out == expected);
+
+                // Reusable after finish
+                normalizer.append(sample, out);
+                normalizer.finish(out);
+                UTEST_ASSERT_TRUE(out == expected + expected);
+            }
+        }
+    }
+
+    // Output is produced before the input ends
+    Normalizer normalizer;
+    std::string out;
+    normalizer.append(u8"é e", out);
+    UTEST_ASSERT_STR_EQUALS(u8"é ", out.c_str());
+    normalizer.append(u8"́", out);
+    normalizer.finish(out);
+    UTEST_ASSERT_STR_EQUALS(u8"é é", out.c_str());
+}
+
+// Test streaming many small chunks, also of text without a stable code point for a long time
+UTEST_FUNC_DEF2(U8ScanNormalization, StreamingManyChunks) {
+    std::string marks = "a";
+    for (int i = 0; i < 20000; ++i) {
+        marks += u8"\u0301";   // 40 KB of non-starters, normalized as one segment at the end
+    }
+    std::string text;
+    while (text.length() < 40000) {
+        text += u8"Ünïcödé é 각 ḍ̇ ﬁ 🌍 " + std::string(7, 'x') + "\xE4\xB8 ";
+    }
+    NormalizationForm forms[] = {NormalizationForm::NFC, NormalizationForm::NFD};
+    for (const std::string* input : {&marks, &text}) {
+        for (NormalizationForm form : forms) {
+            Normalizer normalizer(form);
+            std::string out;
+            for (std::size_t pos = 0; pos < input->length(); ++pos) {
+                normalizer.append(input->substr(pos, 1), out);
+            }
+            normalizer.finish(out);
+            UTEST_ASSERT_TRUE(out == normalize(*input, form));
+        }
+    }
+}
+
+// Main test runner
+int main() {
+    UTEST_PROLOG();
+    UTEST_ENABLE_VERBOSE_MODE();
+
+    // Normalization tests
+    UTEST_FUNC2(U8ScanNormalization, Forms);
+    UTEST_FUNC2(U8ScanNormalization, QuickCheck);
+    UTEST_FUNC2(U8ScanNormalization, Streaming);
+    UTEST_FUNC2(U8ScanNormalization, StreamingManyChunks);
+
+    UTEST_EPILOG();
+}
@@ -0,0 +1,265 @@
+#include "../include/utest/utest.h"
+#include "../include/u8scan/u8scan.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace u8scan;
+
+namespace {
+
+// Build a mixed-content corpus with multi-byte characters of all lengths
+std::string make_corpus(std::size_t repeat) {
+    std::string corpus;
+    for (std::size_t i = 0; i < repeat; ++i) {
+        corpus += u8"Hello 世界! Ünïcödé 123 🌍🚀 Test. ";
+    }
+    return corpus;
+}
+
+// Step through a chunk by position, so that a character crossing the chunk end cannot loop forever
+bool chunk_ends_at_bound(const CharRange& chunk) {
+    std::size_t end = chunk.end().position();
+    auto it = chunk.begin();
+    while (it.position() < end) {
+        ++it;
+    }
+    return it.position() == end;
+}
+
+} // namespace
+
+// Test that every chunk starts on a codepoint boundary
+UTEST_FUNC_DEF2(U8ScanParallel, ChunksStartOnCodepointBoundaries) {
+    std::string input = make_corpus(10);
+
+    for (std::size_t chunks = 1; chunks <= 16; ++chunks) {
+        auto range = make_parallel_char_range(input, chunks);
+        UTEST_ASSERT_EQUALS(chunks, range.chunk_count());
+
+        for (std::size_t i = 0; i < range.chunk_count(); ++i) {
+            auto chunk = range.chunk(i);
+            if (!chunk.empty()) {
+                std::size_t pos = chunk.begin().position();
+                UTEST_ASSERT_TRUE((static_cast<unsigned char>(input[pos]) & 0xC0) != 0x80);
+                UTEST_ASSERT_TRUE(chunk.begin()->is_valid_utf8);
+            }
+        }
+    }
+}
+
+// Test that parallel length matches sequential length()
+UTEST_FUNC_DEF2(U8ScanParallel, LengthMatchesSequential) {
+    std::string input = make_corpus(25);
+    std::size_t expected = length(input);
+
+    for (std::size_t chunks = 1; chunks <= 12; ++chunks) {
+        UTEST_ASSERT_EQUALS(expected, make_parallel_char_range(input, chunks).length());
+    }
+
+    // BOM is skipped like in length()
+    std::string with_bom = bom_str() + input;
+    UTEST_ASSERT_EQUALS(expected, make_parallel_char_range(with_bom, 5).length());
+
+    // ASCII mode counts bytes
+    UTEST_ASSERT_EQUALS(input.length(), make_parallel_char_range(input, 7, false).length());
+
+    // Empty and BOM-only strings
+    UTEST_ASSERT_EQUALS(0u, make_parallel_char_range(std::string(), 4).length());
+    UTEST_ASSERT_EQUALS(0u, make_parallel_char_range(bom_str(), 4).length());
+}
+
+// Test that malformed input is split consistently with the sequential decoder
+UTEST_FUNC_DEF2(U8ScanParallel, InvalidUTF8) {
+    std::string input = "Hello";
+    input += "\x80\x80\x80\x80\x80";     // Stray continuation bytes
+    input += "\xE4\xB8";                  // Truncated 3-byte sequence
+    input += u8"世界";
+    input += "\xFF";                      // Invalid lead byte
+    input += "World";
+
+    std::size_t expected = length(input);
+    for (std::size_t chunks = 1; chunks <= input.length(); ++chunks) {
+        auto range = make_parallel_char_range(input, chunks);
+        UTEST_ASSERT_EQUALS(expected, range.length());
+        UTEST_ASSERT_FALSE(range.validate());
+    }
+}
+
+// Test that without validation no character crosses a chunk end
+UTEST_FUNC_DEF2(U8ScanParallel, UnvalidatedChunksEndAtBounds) {
+    std::string input(1000, 'a');
+    input[499] = '\xF0';                  // Lead byte declaring 4 bytes just before the split
+    auto range = ParallelCharRange(input, 2, true, false);
+    UTEST_ASSERT_TRUE(chunk_ends_at_bound(range.chunk(0)));
+    UTEST_ASSERT_TRUE(chunk_ends_at_bound(range.chunk(1)));
+    UTEST_ASSERT_EQUALS(make_char_range(input, true, false).size(), range.length());
+    UTEST_ASSERT_TRUE(range.validate());
+
+    std::string malformed = "ab\xE4" + std::string("\xF0\xC3x\xF0\xF0\xF0\xF0") + u8"世界" + "\x80\xE4\xB8" + "\xDF";
+    for (std::size_t offset = 0; offset < 8; ++offset) {
+        std::string text = std::string(offset, 'x') + malformed + malformed;
+        for (std::size_t chunks = 1; chunks <= text.length(); ++chunks) {
+            auto split = ParallelCharRange(text, chunks, true, false);
+            for (std::size_t i = 0; i < split.chunk_count(); ++i) {
+                UTEST_ASSERT_TRUE(chunk_ends_at_bound(split.chunk(i)));
+            }
+            split.length();
+            split.validate();
+        }
+    }
+}
+
+// Test count_if with predicates across chunks
+UTEST_FUNC_DEF2(U8ScanParallel, CountIfWithPredicates) {
+    std::string input = make_corpus(20);
+    auto char_range = make_char_range(input);
+    auto range = make_parallel_char_range(input, 6);
+
+    UTEST_ASSERT_EQUALS(static_cast<std::size_t>(std::count_if(char_range.begin(), char_range.end(), predicates::is_ascii())),
+                        range.count_if(predicates::is_ascii()));
+    UTEST_ASSERT_EQUALS(static_cast<std::size_t>(std::count_if(char_range.begin(), char_range.end(), predicates::is_utf8())),
+                        range.count_if(predicates::is_utf8()));
+    UTEST_ASSERT_EQUALS(40u, range.count_if(predicates::is_emoji()));
+    UTEST_ASSERT_EQUALS(60u, range.count_if(predicates::is_digit_ascii()));
+}
+
+// Test validation of well-formed input
+UTEST_FUNC_DEF2(U8ScanParallel, Validate) {
+    std::string input = make_corpus(15);
+    UTEST_ASSERT_TRUE(make_parallel_char_range(input, 8).validate());
+
+    input[input.length() / 2] = static_cast<char>(0xFF);
+    UTEST_ASSERT_FALSE(make_parallel_char_range(input, 8).validate());
+}
+
+// Test custom reductions and exception propagation
+UTEST_FUNC_DEF2(U8ScanParallel, CustomReduce) {
+    std::string input = make_corpus(10);
+    auto range = make_parallel_char_range(input, 4);
+
+    // Total number of bytes in multi-byte characters
+    std::size_t utf8_bytes = range.reduce(std::size_t(0),
+        [](const CharRange& chunk) {
+            std::size_t bytes = 0;
+            for (const auto& info : chunk) {
+                if (!info.is_ascii) bytes += info.byte_count;
+            }
+            return bytes;
+        },
+        [](std::size_t a, std::size_t b) { return a + b; });
+
+    std::string utf8_only;
+    u8scan::copy_if(input, std::back_inserter(utf8_only), predicates::is_utf8());
+    UTEST_ASSERT_EQUALS(utf8_only.length(), utf8_bytes);
+
+    bool thrown = false;
+    try {
+        range.reduce(0, [](const CharRange&) -> int { throw std::runtime_error("chunk failed"); },
+                     [](int a, int b) { return a + b; });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    UTEST_ASSERT_TRUE(thrown);
+}
+
+// Test automatic chunk count selection
+UTEST_FUNC_DEF2(U8ScanParallel, AutomaticChunkCount) {
+    // Small inputs are not split
+    std::string small = make_corpus(2);
+    auto small_range = make_parallel_char_range(small);
+    UTEST_ASSERT_EQUALS(1u, small_range.chunk_count());
+    UTEST_ASSERT_EQUALS(length(small), small_range.length());
+
+    // Large inputs are split into at most one chunk per hardware thread
+    std::string large = make_corpus(20000);
+    auto large_range = make_parallel_char_range(large);
+    UTEST_ASSERT_GTE(large_range.chunk_count(), 1u);
+    UTEST_ASSERT_EQUALS(length(large), large_range.length());
+
+    // Full range iteration is still available
+    UTEST_ASSERT_EQUALS(length(small), static_cast<std::size_t>(std::distance(small_range.begin(), small_range.end())));
+}
+
+// Test that batch outputs match scanning each string separately
+UTEST_FUNC_DEF2(U8ScanParallel, ScanBatchMatchesScanUTF8) {
+    std::vector<std::string> inputs;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        std::string row = "row " + std::to_string(i) + u8" 世界 🌍";
+        if (i % 7 == 0) row = bom_str() + row;
+        if (i % 11 == 0) row.clear();
+        inputs.push_back(row);
+    }
+
+    auto processor = [](const CharInfo& info, const char* /*data*/) -> ProcessResult {
+        if (info.codepoint == ' ') return ProcessResult(ScanAction::REPLACE, "_");
+        if (info.byte_count == 4) return ProcessResult(ScanAction::IGNORE);
+        return ProcessResult(ScanAction::COPY_TO_OUTPUT);
+    };
+
+    for (std::size_t threads = 1; threads <= 8; ++threads) {
+        BatchOutput out;
+        scan_batch(inputs, processor, out, threads);
+
+        UTEST_ASSERT_EQUALS(inputs.size(), out.size());
+        UTEST_ASSERT_EQUALS(out.data.length(), out.offsets.back());
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            std::string expected = scan_utf8(inputs[i], processor);
+            UTEST_ASSERT_EQUALS(expected.length(), out.length(i));
+            UTEST_ASSERT_STR_EQUALS(expected.c_str(), out.str(i).c_str());
+        }
+    }
+}
+
+// Test per-string STOP_SCANNING, empty batches and output reuse
+UTEST_FUNC_DEF2(U8ScanParallel, ScanBatchEdgeCases) {
+    BatchOutput out;
+    scan_batch(std::vector<std::string>(), [](const CharInfo&, const char*) { return ProcessResult(); }, out);
+    UTEST_ASSERT_EQUALS(0u, out.size());
+    UTEST_ASSERT_TRUE(out.data.empty());
+
+    std::vector<std::string> inputs = {"key=value", u8"名前=値", "no separator", ""};
+    auto until_equals = [](const CharInfo& info, const char* /*data*/) -> ProcessResult {
+        return info.codepoint == '=' ? ProcessResult(ScanAction::STOP_SCANNING) : ProcessResult();
+    };
+    scan_batch(inputs, until_equals, out, 3);
+
+    UTEST_ASSERT_EQUALS(4u, out.size());
+    UTEST_ASSERT_STR_EQUALS("key", out.str(0).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"名前", out.str(1).c_str());
+    UTEST_ASSERT_STR_EQUALS("no separator", out.str(2).c_str());
+    UTEST_ASSERT_EQUALS(0u, out.length(3));
+    UTEST_ASSERT_EQUALS(std::string("key") + u8"名前" + "no separator", out.data);
+    UTEST_ASSERT_TRUE(std::string(out.data_at(1), out.length(1)) == u8"名前");
+
+    bool thrown = false;
+    try {
+        scan_batch(inputs, [](const CharInfo&, const char*) -> ProcessResult { throw std::runtime_error("bad row"); }, out, 2);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    UTEST_ASSERT_TRUE(thrown);
+}
+
+// Main test runner
+int main() {
+    UTEST_PROLOG();
+    UTEST_ENABLE_VERBOSE_MODE();
+
+    // Chunked range tests
+    UTEST_FUNC2(U8ScanParallel, ChunksStartOnCodepointBoundaries);
+    UTEST_FUNC2(U8ScanParallel, LengthMatchesSequential);
+    UTEST_FUNC2(U8ScanParallel, InvalidUTF8);
+    UTEST_FUNC2(U8ScanParallel, UnvalidatedChunksEndAtBounds);
+    UTEST_FUNC2(U8ScanParallel, CountIfWithPredicates);
+    UTEST_FUNC2(U8ScanParallel, Validate);
+    UTEST_FUNC2(U8ScanParallel, CustomReduce);
+    UTEST_FUNC2(U8ScanParallel, AutomaticChunkCount);
+
+    // Batch scanning tests
+    UTEST_FUNC2(U8ScanParallel, ScanBatchMatchesScanUTF8);
+    UTEST_FUNC2(U8ScanParallel, ScanBatchEdgeCases);
+
+    UTEST_EPILOG();
+}
@@ -0,0 +1,335 @@
+#include "../include/utest/utest.h"
+#include "../include/u8scan/u8scan.h"
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace u8scan;
+
+namespace {
+
+// Characters of input matching a predicate
+std::string matching(const std::string& input, const std::function<bool(const CharInfo&)>& predicate) {
+    std::string result;
+    u8scan::copy_if(input, std::back_inserter(result), predicate);
+    return result;
+}
+
+} // namespace
+
+// Test general_category() for representative characters of every category group
+UTEST_FUNC_DEF2(U8ScanPredicates, GeneralCategory) {
+    struct Case { uint32_t cp; GeneralCategory expected; };
+    std::vector<Case> cases = {
+        {'A', GeneralCategory::Lu}, {'z', GeneralCategory::Ll}, {0x01C5, GeneralCategory::Lt},
+        {0x02B0, GeneralCategory::Lm}, {0x4E16, GeneralCategory::Lo}, {0x0301, GeneralCategory::Mn},
+        {0x0903, GeneralCategory::Mc}, {0x20DD, GeneralCategory::Me}, {'7', GeneralCategory::Nd},
+        {0x0663, GeneralCategory::Nd}, {0x216B, GeneralCategory::Nl}, {0x00BD, GeneralCategory::No},
+        {'_', GeneralCategory::Pc}, {'-', GeneralCategory::Pd}, {'(', GeneralCategory::Ps},
+        {')', GeneralCategory::Pe}, {0x00AB, GeneralCategory::Pi}, {0x00BB, GeneralCategory::Pf},
+        {'!', GeneralCategory::Po}, {'+', GeneralCategory::Sm}, {0x20AC, GeneralCategory::Sc},
+        {'^', GeneralCategory::Sk}, {0x1F30D, GeneralCategory::So}, {0x3000, GeneralCategory::Zs},
+        {0x2028, GeneralCategory::Zl}, {0x2029, GeneralCategory::Zp}, {'\n', GeneralCategory::Cc},
+        {0x200D, GeneralCategory::Cf}, {0xD800, GeneralCategory::Cs}, {0xE000, GeneralCategory::Co},
+        {0x10FFFD, GeneralCategory::Co}, {0x0378, GeneralCategory::Cn}, {0x10FFFF, GeneralCategory::Cn},
+        {0x110000, GeneralCategory::Cn},
+    };
+    for (const auto& c : cases) {
+        UTEST_ASSERT_TRUE(general_category(c.cp) == c.expected);
+    }
+
+    // CJK and Hangul ranges from First/Last entries of the UCD
+    UTEST_ASSERT_TRUE(general_category(0x9FA5) == GeneralCategory::Lo);
+    UTEST_ASSERT_TRUE(general_category(0xAC01) == GeneralCategory::Lo);
+    UTEST_ASSERT_TRUE(general_category(0x2A6DF) == GeneralCategory::Lo);
+}
+
+// Test letter, case, mark and number predicates across scripts
+UTEST_FUNC_DEF2(U8ScanPredicates, LettersAndNumbers) {
+    std::string text = u8"Ünïcödé 123 世界! Ωμέγα ٣٤ Ⅻ½² é ǅ";
+    UTEST_ASSERT_STR_EQUALS(u8"Ünïcödé世界Ωμέγαeǅ", matching(text, predicates::is_letter()).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"ÜΩ", matching(text, predicates::is_uppercase()).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"nïcödéμέγαe", matching(text, predicates::is_lowercase()).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"́", matching(text, predicates::is_mark()).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"123٣٤", matching(text, predicates::is_digit()).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"123٣٤Ⅻ½²", matching(text, predicates::is_number()).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"Ünïcödé123世界Ωμέγα٣٤Ⅻ½²eǅ", matching(text, predicates::is_alphanum()).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"ǅ", matching(text, predicates::has_category(GeneralCategory::Lt)).c_str());
+}
+
+// Test punctuation, symbol, whitespace and control predicates
+UTEST_FUNC_DEF2(U8ScanPredicates, PunctuationAndSpaces) {
+    std::string text = u8"a-b (c) «d» ¿e? f_g. $5 + €3 = ^ 🌍\t\n　\u0085​\u0001";
+    UTEST_ASSERT_STR_EQUALS(u8"-()«»¿?_.", matching(text, predicates::is_punct()).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"$+€=^🌍", matching(text, predicates::is_symbol()).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"\t\n\u0085\u0001", matching(text, predicates::is_control()).c_str());
+    UTEST_ASSERT_STR_EQUALS((std::string(10, ' ') + u8"\t\n　\u0085").c_str(),
+                            matching(text, predicates::is_whitespace()).c_str());   // Not U+200B
+}
+
+// Test that invalid bytes match no category and that predicates agree with the ASCII ones
+UTEST_FUNC_DEF2(U8ScanPredicates, AsciiAndInvalid) {
+    std::string invalid = std::string("\xC3\xFF") + "\xE4\xB8";
+    UTEST_ASSERT_EQUALS(0u, matching(invalid, predicates::is_letter()).length());
+    UTEST_ASSERT_EQUALS(0u, matching(invalid, predicates::is_symbol()).length());
+    UTEST_ASSERT_EQUALS(0u, matching(invalid, predicates::is_whitespace()).length());
+    UTEST_ASSERT_EQUALS(0u, matching(invalid, predicates::has_category(GeneralCategory::Cn)).length());
+
+    std::string ascii;
+    for (int c = 0; c < 0x80; ++c) ascii += static_cast<char>(c);
+    UTEST_ASSERT_TRUE(matching(ascii, predicates::is_letter()) == matching(ascii, predicates::is_alpha_ascii()));
+    UTEST_ASSERT_TRUE(matching(ascii, predicates::is_digit()) == matching(ascii, predicates::is_digit_ascii()));
+    UTEST_ASSERT_TRUE(matching(ascii, predicates::is_alphanum()) == matching(ascii, predicates::is_alphanum_ascii()));
+    UTEST_ASSERT_TRUE(matching(ascii, predicates::is_uppercase()) == matching(ascii, predicates::is_uppercase_ascii()));
+    UTEST_ASSERT_TRUE(matching(ascii, predicates::is_lowercase()) == matching(ascii, predicates::is_lowercase_ascii()));
+    UTEST_ASSERT_STR_EQUALS("!\"#%&'()*,-./:;?@[\\]_{}", matching(ascii, predicates::is_punct()).c_str());
+    UTEST_ASSERT_STR_EQUALS("$+<=>^`|~", matching(ascii, predicates::is_symbol()).c_str());
+    UTEST_ASSERT_STR_EQUALS("\t\n\x0B\x0C\r ", matching(ascii, predicates::is_whitespace()).c_str());
+}
+
+// Test that the functor forms agree with the std::function factories
+UTEST_FUNC_DEF2(U8ScanPredicates, Functors) {
+    std::string text = std::string(u8"Ünïcödé 123 世界! Ωμέγα ٣٤ Ⅻ½² (a-b) $5 + €3 🌍🇺🇸 ©\t\n　\u0085") + "\xFF\xE4\xB8";
+    auto range = make_char_range(text);
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        const CharInfo& info = *it;
+        UTEST_ASSERT_EQUALS(predicates::is_ascii()(info), predicates::is_ascii_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_utf8()(info), predicates::is_utf8_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_valid()(info), predicates::is_valid_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::has_codepoint(0x4E16)(info), predicates::has_codepoint_t(0x4E16)(info));
+        UTEST_ASSERT_EQUALS(predicates::in_range('a', 0x3A9)(info), predicates::in_range_t('a', 0x3A9)(info));
+        UTEST_ASSERT_EQUALS(predicates::is_digit_ascii()(info), predicates::is_digit_ascii_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_alpha_ascii()(info), predicates::is_alpha_ascii_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_alphanum_ascii()(info), predicates::is_alphanum_ascii_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_lowercase_ascii()(info), predicates::is_lowercase_ascii_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_uppercase_ascii()(info), predicates::is_uppercase_ascii_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_whitespace_ascii()(info), predicates::is_whitespace_ascii_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::has_category(GeneralCategory::Sc)(info),
+                            predicates::has_category_t(GeneralCategory::Sc)(info));
+        UTEST_ASSERT_EQUALS(predicates::is_letter()(info), predicates::is_letter_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_uppercase()(info), predicates::is_uppercase_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_lowercase()(info), predicates::is_lowercase_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_mark()(info), predicates::is_mark_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_digit()(info), predicates::is_digit_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_number()(info), predicates::is_number_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_alphanum()(info), predicates::is_alphanum_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_punct()(info), predicates::is_punct_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_symbol()(info), predicates::is_symbol_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_whitespace()(info), predicates::is_whitespace_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_control()(info), predicates::is_control_t()(info));
+        UTEST_ASSERT_EQUALS(predicates::is_emoji()(info), predicates::is_emoji_t()(info));
+    }
+
+    // Functors work with STL algorithms and the u8scan copy functions
+    UTEST_ASSERT_EQUALS(7, std::count_if(range.begin(), range.end(), predicates::is_digit_t()));
+    UTEST_ASSERT_STR_EQUALS(u8"世界", matching(text, predicates::in_range_t(0x4E00, 0x9FFF)).c_str());
+    std::string symbols;
+    u8scan::copy_if(text, std::back_inserter(symbols), predicates::is_symbol_t());
+    UTEST_ASSERT_STR_EQUALS(u8"$+€🌍🇺🇸©", symbols.c_str());
+}
+
+// Test that any_of(), all_of() and not_() compile class operands into a CharClass
+UTEST_FUNC_DEF2(U8ScanPredicates, Combinators) {
+    using namespace predicates;
+    auto identifier = any_of(is_alphanum_ascii_t(), has_codepoint_t('_'), in_range_t(0x4E00, 0x9FFF));
+    auto separator = not_(identifier);
+    auto consonant = all_of(is_alpha_ascii_t(), not_(any_of(has_codepoint_t('a'), has_codepoint_t('e'),
+                                                            has_codepoint_t('i'), has_codepoint_t('o'), has_codepoint_t('u'))));
+    UTEST_ASSERT_TRUE((std::is_same<decltype(identifier), CharClass>::value));
+    UTEST_ASSERT_TRUE((std::is_same<decltype(separator), CharClass>::value));
+    UTEST_ASSERT_TRUE((std::is_same<decltype(consonant), CharClass>::value));
+
+    // Operands that are not classes are kept as predicates
+    auto word = any_of(is_letter_t(), is_digit_ascii_t(), has_codepoint_t('_'));
+    auto upper_or_digit = any_of(is_uppercase(), is_digit_ascii_t());
+    auto not_letter = not_(is_letter_t());
+    UTEST_ASSERT_TRUE(!(std::is_same<decltype(word), CharClass>::value));
+    UTEST_ASSERT_TRUE(!(std::is_same<decltype(not_letter), CharClass>::value));
+
+    std::string text = std::string(u8"snake_case 42 世界 Ünïcödé\t(x) ") + "\xFF\xE4\xB8";
+    UTEST_ASSERT_STR_EQUALS(u8"snake_case42世界ncdx", matching(text, identifier).c_str());
+    UTEST_ASSERT_STR_EQUALS((std::string(u8"   Üïöé\t() ") + "\xFF\xE4\xB8").c_str(), matching(text, separator).c_str());
+    UTEST_ASSERT_STR_EQUALS("snkcsncdx", matching(text, consonant).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"snake_case42世界Ünïcödéx", matching(text, word).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"42Ü", matching(text, upper_or_digit).c_str());
+    UTEST_ASSERT_STR_EQUALS((std::string(u8"_ 42  \t() ") + "\xFF\xE4\xB8").c_str(), matching(text, not_letter).c_str());
+
+    // CharClass agrees with the predicates it was built from, including for invalid bytes
+    auto range = make_char_range(text);
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        const CharInfo& info = *it;
+        bool in_identifier = is_alphanum_ascii_t()(info) || info.codepoint == '_' || in_range_t(0x4E00, 0x9FFF)(info);
+        UTEST_ASSERT_EQUALS(in_identifier, identifier(info));
+        UTEST_ASSERT_EQUALS(!in_identifier, separator(info));
+        UTEST_ASSERT_EQUALS(is_whitespace_ascii()(info), not_(not_(is_whitespace_ascii_t()))(info));
+    }
+
+    // Set operations at the ends of the codepoint space
+    CharClass all = ~CharClass();
+    UTEST_ASSERT_TRUE(all.contains(0) && all.contains(0x80) && all.contains(0xFFFFFFFFu));
+    UTEST_ASSERT_EQUALS(1u, all.ranges().size());
+    CharClass high = CharClass(0x10000, 0xFFFFFFFFu) | CharClass(0x80, 0xFFFF);
+    UTEST_ASSERT_EQUALS(1u, high.ranges().size());
+    UTEST_ASSERT_EQUALS(0u, (~high).ranges().size());
+    UTEST_ASSERT_TRUE((high & CharClass(0x100, 0x1FF)).contains(0x1FF));
+    UTEST_ASSERT_TRUE(!(high & CharClass(0x100, 0x1FF)).contains(0x200));
+    UTEST_ASSERT_TRUE(!CharClass(5, 4).contains(4));
+}
+
+// Test find_if() and count_if() on strings against the iterator for every block alignment
+UTEST_FUNC_DEF2(U8ScanPredicates, CharClassScan) {
+    using namespace predicates;
+    std::vector<CharClass> classes = {
+        any_of(is_digit_ascii_t(), has_codepoint_t('_')),
+        not_(is_alpha_ascii_t()),
+        any_of(is_whitespace_ascii_t(), in_range_t(0x4E00, 0x9FFF)),
+        any_of(in_range_t(0x80, 0xFF), has_codepoint_t(0x1F30D)),      // Latin-1 and invalid bytes
+        any_of(is_alphanum_ascii_t(), has_codepoint_t('_')),
+        all_of(is_alpha_ascii_t(), not_(has_codepoint_t('a'))),
+        any_of(in_range_t(0, 0x7F), in_range_t(0xD800, 0xDFFF)),
+        CharClass(),
+    };
+    // Overlong forms of 'A' and NUL and an encoded surrogate decode to members in make_char_range()
+    std::string chunk = std::string(u8"abc 12_ Ünï 世界 🌍 xyz") + "\xFF\xC3" + "q\xC1\x81_\xE0\x80\x80" + "\xED\xA0\x80";
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        std::string text = std::string(offset, 'a') + chunk + std::string(offset % 7, 'z');
+        for (const auto& cls : classes) {
+            auto range = make_char_range(text);
+            auto it = std::find_if(range.begin(), range.end(), cls);
+            std::size_t expected_pos = it == range.end() ? std::string::npos : it.position();
+            UTEST_ASSERT_EQUALS(expected_pos, u8scan::find_if(text, cls));
+            UTEST_ASSERT_EQUALS(static_cast<std::size_t>(std::count_if(range.begin(), range.end(), cls)),
+                                u8scan::count_if(text, cls));
+        }
+    }
+
+    // The generic overloads and a BOM
+    std::string with_bom = bom_str() + u8"x1 世";
+    UTEST_ASSERT_EQUALS(3u, u8scan::find_if(with_bom, not_(is_digit_ascii_t())));
+    UTEST_ASSERT_EQUALS(4u, u8scan::find_if(with_bom, is_digit_ascii_t()));
+    UTEST_ASSERT_EQUALS(3u, u8scan::find_if(with_bom, is_letter_t()));
+    UTEST_ASSERT_EQUALS(2u, u8scan::count_if(with_bom, is_letter()));
+    UTEST_ASSERT_EQUALS(3u, u8scan::count_if(with_bom, not_(has_codepoint_t(' '))));
+    UTEST_ASSERT_EQUALS(std::string::npos, u8scan::find_if(with_bom, has_codepoint_t(0xFEFF)));
+    UTEST_ASSERT_EQUALS(0u, u8scan::count_if(std::string(), ~CharClass()));
+
+    // Overlong ASCII is never a member, whichever path decodes it
+    CharClass alpha = any_of(is_alpha_ascii_t(), has_codepoint_t('_'));
+    UTEST_ASSERT_FALSE(alpha(*make_char_range("\xC1\x81").begin()));
+    UTEST_ASSERT_EQUALS(0u, u8scan::count_if("\xC1\x81", alpha));
+    UTEST_ASSERT_EQUALS(std::string::npos, u8scan::find_if("\xC1\x81", alpha));
+    UTEST_ASSERT_EQUALS(0u, u8scan::count_if("\xC1\x81", alpha | CharClass(0x100, 0x200)));
+}
+
+// Test CodepointSet membership and set operations against a plain bitmap
+UTEST_FUNC_DEF2(U8ScanPredicates, CodepointSet) {
+    CodepointSet letters;
+    letters.insert_range('A', 'Z').insert_range('a', 'z').insert_range(0xC0, 0x24F).insert_range(0x4E00, 0x9FFF)
+           .insert(0x1F30D).insert_range(0x20000, 0x2A6DF);
+    CodepointSet other;
+    other.insert_range('0', 'z').insert_range(0x100, 0x4E10).insert_range(0xFFF0, 0x10005).insert_range(0x2A000, 0x10FFFF);
+
+    std::vector<bool> in_letters(0x110000);
+    std::vector<bool> in_other(0x110000);
+    for (uint32_t cp = 0; cp < 0x110000; ++cp) {
+        in_letters[cp] = (cp >= 'A' && cp <= 'Z') || (cp >= 'a' && cp <= 'z') || (cp >= 0xC0 && cp <= 0x24F) ||
+                         (cp >= 0x4E00 && cp <= 0x9FFF) || cp == 0x1F30D || (cp >= 0x20000 && cp <= 0x2A6DF);
+        in_other[cp] = (cp >= '0' && cp <= 'z') || (cp >= 0x100 && cp <= 0x4E10) ||
+                       (cp >= 0xFFF0 && cp <= 0x10005) || cp >= 0x2A000;
+    }
+
+    CodepointSet both = letters & other;
+    CodepointSet either = letters | other;
+    CodepointSet copy = letters;
+    copy |= other;
+    std::size_t letters_size = 0;
+    std::size_t both_size = 0;
+    bool all_agree = true;
+    for (uint32_t cp = 0; cp < 0x110000; ++cp) {
+        all_agree = all_agree && letters.contains(cp) == in_letters[cp] && other.contains(cp) == in_other[cp] &&
+                    both.contains(cp) == (in_letters[cp] && in_other[cp]) &&
+                    either.contains(cp) == (in_letters[cp] || in_other[cp]) && copy.contains(cp) == either.contains(cp);
+        letters_size += in_letters[cp] ? 1u : 0u;
+        both_size += in_letters[cp] && in_other[cp] ? 1u : 0u;
+    }
+    UTEST_ASSERT_TRUE(all_agree);
+    UTEST_ASSERT_EQUALS(letters_size, letters.size());
+    UTEST_ASSERT_EQUALS(both_size, both.size());
+    UTEST_ASSERT_TRUE(!either.contains(0x110000) && !either.contains(0xFFFFFFFFu));
+
+    // Empty sets and ranges beyond U+10FFFF
+    CodepointSet none;
+    UTEST_ASSERT_TRUE(none.empty() && (none & letters).empty());
+    UTEST_ASSERT_EQUALS(0u, none.insert_range(0x110000, 0x120000).insert_range(9, 8).size());
+    UTEST_ASSERT_EQUALS(0x10u, none.insert_range(0x10FFF0, 0xFFFFFFFFu).size());
+
+    // As a predicate, invalid bytes do not match even when their byte value is in the set
+    std::string text = std::string(u8"Çà 世 🌍x") + "\xC3" + "\xFF";
+    UTEST_ASSERT_STR_EQUALS(u8"Çà世🌍x", matching(text, letters).c_str());
+}
+
+// Test span_matching() against expected prefixes for every block alignment
+UTEST_FUNC_DEF2(U8ScanPredicates, SpanMatching) {
+    CodepointSet identifier;
+    identifier.insert_range('a', 'z').insert_range('0', '9').insert('_').insert_range(0x4E00, 0x9FFF).insert(0x1F30D);
+
+    UTEST_ASSERT_EQUALS(0u, span_matching("", identifier));
+    UTEST_ASSERT_EQUALS(0u, span_matching(" abc", identifier));
+    UTEST_ASSERT_EQUALS(11u, span_matching(u8"變數_name = 1", identifier));
+    UTEST_ASSERT_EQUALS(8u, span_matching(u8"a🌍_42", identifier));
+    UTEST_ASSERT_EQUALS(8u, span_matching(u8"a🌍_42Ω", identifier));
+    UTEST_ASSERT_EQUALS(6u, span_matching(bom_str() + "abc", identifier));           // A BOM is included
+    UTEST_ASSERT_EQUALS(1u, span_matching("a\xE4\xB8", identifier));                  // Truncated sequence
+    UTEST_ASSERT_EQUALS(1u, span_matching("a\xE0\x80\xB0", identifier));              // Overlong form of '0'
+
+    std::string chunk = u8"snake_case_42_世界_🌍_abc";
+    for (std::size_t offset = 0; offset < 40; ++offset) {
+        std::string prefix(offset, 'x');
+        UTEST_ASSERT_EQUALS(offset + chunk.length(), span_matching(prefix + chunk + u8" tail", identifier));
+        UTEST_ASSERT_EQUALS(offset + chunk.length(), span_matching(prefix + chunk + u8"Ω", identifier));
+        UTEST_ASSERT_EQUALS(offset + chunk.length(), span_matching(prefix + chunk + "\xFF" + chunk, identifier));
+        UTEST_ASSERT_EQUALS(offset + chunk.length() + 6, span_matching(prefix + chunk + u8"abcdef", identifier));
+    }
+
+    // Equal to the position where the set as a predicate first fails on well-formed input
+    std::string text = u8"abc_世界_🌍_xyz_0123456789_abcdefghijklmnopqrstuvwxyz ÀÉ";
+    auto range = make_char_range(text);
+    auto stop = std::find_if_not(range.begin(), range.end(), identifier);
+    UTEST_ASSERT_EQUALS(stop.position(), span_matching(text, identifier));
+
+    // Also on overlong forms and encoded surrogates, which make_char_range() decodes
+    CodepointSet all;
+    all.insert_range(0, 0x10FFFF);
+    for (const std::string& ill_formed : {std::string("ab\xC1\x81"), std::string("ab\xE0\x80\xB0"), std::string("ab\xED\xA0\x80")}) {
+        auto ill_range = make_char_range(ill_formed);
+        UTEST_ASSERT_EQUALS(2u, std::find_if_not(ill_range.begin(), ill_range.end(), all).position());
+        UTEST_ASSERT_EQUALS(2u, span_matching(ill_formed, all));
+    }
+}
+
+// Main test runner
+int main() {
+    UTEST_PROLOG();
+    UTEST_ENABLE_VERBOSE_MODE();
+
+    // General category tests
+    UTEST_FUNC2(U8ScanPredicates, GeneralCategory);
+    UTEST_FUNC2(U8ScanPredicates, LettersAndNumbers);
+    UTEST_FUNC2(U8ScanPredicates, PunctuationAndSpaces);
+    UTEST_FUNC2(U8ScanPredicates, AsciiAndInvalid);
+
+    // Functor tests
+    UTEST_FUNC2(U8ScanPredicates, Functors);
+
+    // Combinator tests
+    UTEST_FUNC2(U8ScanPredicates, Combinators);
+    UTEST_FUNC2(U8ScanPredicates, CharClassScan);
+
+    // CodepointSet tests
+    UTEST_FUNC2(U8ScanPredicates, CodepointSet);
+    UTEST_FUNC2(U8ScanPredicates, SpanMatching);
+
+    UTEST_EPILOG();
+}
@@ -571,6 +571,171 @@ UTEST_FUNC_DEF2(U8Scan, UTF8StringLiterals) {
 // Note: String conversion functions (to_string, to_lower_ascii_str, to_upper_ascii_str) 
 // are tested and verified to work correctly in the demo applications
 
+// Test fused pipeline against the equivalent chain of separate passes
+UTEST_FUNC_DEF2(U8Scan, PipelineMatchesSeparatePasses) {
+    std::string input = u8"Hello 世界! Émoji 🌍 Test\t123";
+
+    // copy_if -> transform_chars -> scan_utf8
+    std::string filtered;
+    u8scan::copy_if(input, std::back_inserter(filtered), [](const CharInfo& info) { return !info.is_ascii || info.codepoint != '!'; });
+    std::string mapped = scan_utf8(filtered, [](const CharInfo& info, const char*) {
+        return ProcessResult(ScanAction::REPLACE, to_lower_ascii_str(info));
+    });
+    std::string expected = scan_utf8(mapped, [](const CharInfo& info, const char*) {
+        return info.codepoint == ' ' || info.codepoint == '\t' ? ProcessResult(ScanAction::REPLACE, "_") : ProcessResult();
+    });
+
+    auto fused = pipeline()
+        .filter([](const CharInfo& info) { return !info.is_ascii || info.codepoint != '!'; })
+        .map([](const CharInfo& info) { return to_lower_ascii(info); })
+        .replace([](const CharInfo& info) { return info.codepoint == ' ' || info.codepoint == '\t'; }, "_");
+
+    UTEST_ASSERT_STR_EQUALS(expected.c_str(), fused(input).c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"hello_世界_Émoji_🌍_test_123", fused.run(input).c_str());
+
+    // Output iterator variant
+    std::vector<char> bytes;
+    fused.run(input, std::back_inserter(bytes));
+    UTEST_ASSERT_STR_EQUALS(expected.c_str(), std::string(bytes.begin(), bytes.end()).c_str());
+}
+
+// Test stage ordering, non-ASCII mapping, BOM and invalid bytes
+UTEST_FUNC_DEF2(U8Scan, PipelineStageSemantics) {
+    // Replaced characters bypass later stages
+    auto replace_then_filter = pipeline()
+        .replace(predicates::is_digit_ascii(), "#")
+        .filter(predicates::is_alpha_ascii());
+    UTEST_ASSERT_STR_EQUALS("ab##c", replace_then_filter("a-b12 c").c_str());
+
+    // Filter before replace drops characters first
+    auto filter_then_replace = pipeline()
+        .filter(predicates::is_alphanum_ascii())
+        .replace(predicates::is_digit_ascii(), "#");
+    UTEST_ASSERT_STR_EQUALS("ab##c", filter_then_replace("a-b12 c").c_str());
+
+    // Mapped codepoints are re-encoded as UTF-8, later stages see the mapped value
+    auto shift = pipeline()
+        .map([](const CharInfo& info) -> uint32_t { return info.codepoint == 'x' ? 0x4E16 : info.codepoint; })
+        .filter([](const CharInfo& info) { return info.codepoint != 'y'; });
+    UTEST_ASSERT_STR_EQUALS(u8"a世b世", shift("axbyx").c_str());
+
+    // BOM is skipped, invalid bytes pass through unchanged
+    std::string input = bom_str() + "A\xFF" + u8"界";
+    auto upper = pipeline().map([](const CharInfo& info) { return to_upper_ascii(info); });
+    UTEST_ASSERT_STR_EQUALS((std::string("A\xFF") + u8"界").c_str(), upper(input).c_str());
+
+    // Stateful functors are copied per run
+    std::size_t calls = 0;
+    auto counting = pipeline().filter([&calls](const CharInfo&) { ++calls; return true; });
+    UTEST_ASSERT_STR_EQUALS(u8"世界", counting(u8"世界").c_str());
+    UTEST_ASSERT_EQUALS(2u, calls);
+
+    // Empty pipeline copies the input
+    UTEST_ASSERT_STR_EQUALS(u8"Hello 世界", pipeline()(u8"Hello 世界").c_str());
+    UTEST_ASSERT_TRUE(pipeline()("").empty());
+}
+
+// Test table-driven scanning for common escaping tasks
+UTEST_FUNC_DEF2(U8Scan, ByteActionTableEscaping) {
+    ByteActionTable table;
+    table.replace('"', "\\\"")
+         .replace('\\', "\\\\")
+         .replace('\t', "    ")
+         .ignore_range(0x00, 0x08);
+
+    std::string input = std::string("Say \"世界\"\tpath\\to") + '\x01' + u8"🌍";
+    UTEST_ASSERT_STR_EQUALS(u8"Say \\\"世界\\\"    path\\\\to🌍", scan_utf8(input, table).c_str());
+
+    // Unchanged input, BOM is skipped like in scan_utf8()
+    UTEST_ASSERT_STR_EQUALS(u8"Hello 世界", scan_utf8(bom_str() + u8"Hello 世界", table).c_str());
+    UTEST_ASSERT_TRUE(scan_utf8(std::string(), table).empty());
+
+    // Stop scanning at the first newline
+    ByteActionTable first_line;
+    first_line.stop_at('\n');
+    UTEST_ASSERT_STR_EQUALS(u8"línea 1", scan_utf8(u8"línea 1\nlínea 2", first_line).c_str());
+
+    // Actions on bytes >= 0x80 apply to every byte of multi-byte characters
+    ByteActionTable strip_non_ascii;
+    strip_non_ascii.ignore_range(0x80, 0xFF);
+    UTEST_ASSERT_STR_EQUALS("Hello !", scan_utf8(u8"Hello 世界!", strip_non_ascii).c_str());
+
+    // An action on a single byte >= 0x80 works on that byte only, also inside a character
+    ByteActionTable lead_byte;
+    lead_byte.replace(0xE4, "?");
+    UTEST_ASSERT_TRUE(scan_utf8(u8"a世b", lead_byte) == "a?\xB8\x96" "b");
+
+    // An inverted range sets nothing
+    ByteActionTable inverted;
+    inverted.set_range('z', 'a', ScanAction::IGNORE);
+    std::string long_text = std::string(u8"Inverted ranges leave every byte alone, 世界 🌍 ") + std::string(40, 'q');
+    UTEST_ASSERT_TRUE(scan_utf8(long_text, inverted) == long_text);
+
+    // Resetting an action back to copy
+    table.set('"', ScanAction::COPY_TO_OUTPUT);
+    UTEST_ASSERT_STR_EQUALS("\"a\"", scan_utf8("\"a\"", table).c_str());
+}
+
+// Test that table-driven scanning matches an equivalent processor at every offset
+UTEST_FUNC_DEF2(U8Scan, ByteActionTableMatchesProcessor) {
+    ByteActionTable table;
+    table.replace('<', "&lt;").replace('>', "&gt;").replace('&', "&amp;").ignore('\r');
+
+    auto processor = [](const CharInfo& info, const char* /*data*/) -> ProcessResult {
+        switch (info.codepoint) {
+            case '<': return ProcessResult(ScanAction::REPLACE, "&lt;");
+            case '>': return ProcessResult(ScanAction::REPLACE, "&gt;");
+            case '&': return ProcessResult(ScanAction::REPLACE, "&amp;");
+            case '\r': return ProcessResult(ScanAction::IGNORE);
+            default: return ProcessResult(ScanAction::COPY_TO_OUTPUT);
+        }
+    };
+
+    std::string padding = u8"The quick brown fox 世界 jumps over the lazy dog 🌍 0123456789 ";
+    for (std::size_t offset = 0; offset < 70; ++offset) {
+        std::string input = padding.substr(0, offset) + "<b>&\r\n" + padding + padding.substr(offset % 20) + ">";
+        UTEST_ASSERT_STR_EQUALS(scan_utf8(input, processor).c_str(), scan_utf8(input, table).c_str());
+    }
+
+    // Sets with many ranges use the generic classification
+    ByteActionTable scattered;
+    for (unsigned char c = 'a'; c <= 'z'; c = static_cast<unsigned char>(c + 2)) {
+        scattered.ignore(c);
+    }
+    std::string text = padding + padding + padding;
+    std::string expected = scan_utf8(text, [](const CharInfo& info, const char*) {
+        bool drop = info.codepoint >= 'a' && info.codepoint <= 'z' && (info.codepoint - 'a') % 2 == 0;
+        return ProcessResult(drop ? ScanAction::IGNORE : ScanAction::COPY_TO_OUTPUT);
+    });
+    UTEST_ASSERT_STR_EQUALS(expected.c_str(), scan_utf8(text, scattered).c_str());
+}
+
+// Test whole-string ASCII case conversion against per-character conversion
+UTEST_FUNC_DEF2(U8Scan, WholeStringCaseConversion) {
+    std::string text = u8"Hello WORLD @[`{ Ünïcödé 世界 🌍 azAZ ";
+    std::string input = bom_str();
+    for (int i = 0; i < 4; ++i) input += text;
+    input += "\xC3\x9A\xFF";  // Trailing bytes are never letters
+
+    for (std::size_t len = 0; len <= input.length(); ++len) {
+        std::string prefix = input.substr(0, len);
+        std::string expected_lower, expected_upper;
+        for (char c : prefix) {
+            expected_lower += (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c;
+            expected_upper += (c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c;
+        }
+        UTEST_ASSERT_TRUE(to_lower_ascii_str(prefix) == expected_lower);
+        UTEST_ASSERT_TRUE(to_upper_ascii_str(prefix) == expected_upper);
+
+        std::string in_place = prefix;
+        UTEST_ASSERT_TRUE(to_lower_ascii(in_place) == expected_lower);
+        UTEST_ASSERT_TRUE(to_upper_ascii(in_place) == expected_upper);
+    }
+
+    UTEST_ASSERT_STR_EQUALS(u8"hello wörld 世界", to_lower_ascii_str(u8"HELLO Wörld 世界").c_str());
+    UTEST_ASSERT_STR_EQUALS(u8"HELLO WöRLD 世界", to_upper_ascii_str(std::string(u8"hello wörld 世界")).c_str());
+}
+
 // Run all tests
 int main() {
     UTEST_PROLOG();
@@ -606,5 +771,16 @@ int main() {
     UTEST_FUNC2(U8Scan, PredicateFunctions);
     UTEST_FUNC2(U8Scan, CharIteratorFunctionality);
     
+    // Fused pipeline tests
+    UTEST_FUNC2(U8Scan, PipelineMatchesSeparatePasses);
+    UTEST_FUNC2(U8Scan, PipelineStageSemantics);
+    
+    // Table-driven scanning tests
+    UTEST_FUNC2(U8Scan, ByteActionTableEscaping);
+    UTEST_FUNC2(U8Scan, ByteActionTableMatchesProcessor);
+    
+    // Whole-string conversion tests
+    UTEST_FUNC2(U8Scan, WholeStringCaseConversion);
+    
     UTEST_EPILOG();
 }
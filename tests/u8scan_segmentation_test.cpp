@@ -0,0 +1,236 @@
+#include "../include/utest/utest.h"
+#include "../include/u8scan/u8scan.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace u8scan;
+
+namespace {
+
+// Split a string into the substrings of its segments
+template<typename Range>
+std::vector<std::string> split(const std::string& input, const Range& range) {
+    std::vector<std::string> parts;
+    for (const auto& segment : range) {
+        parts.push_back(input.substr(segment.start_pos, segment.byte_count));
+    }
+    return parts;
+}
+
+} // namespace
+
+// Test grapheme clusters of combining sequences, Hangul, emoji and flags
+UTEST_FUNC_DEF2(U8ScanSegmentation, GraphemeClusters) {
+    struct Case { std::string input; std::vector<std::string> expected; };
+    std::vector<Case> cases = {
+        {"", {}},
+        {"abc", {"a", "b", "c"}},
+        {"a\r\nb\n\r", {"a", "\r\n", "b", "\n", "\r"}},
+        {u8"e\u0301x", {u8"e\u0301", "x"}},                            // e + combining acute
+        {u8"नमस्ते", {u8"न", u8"म", u8"स्", u8"ते"}},                       // Virama does not join (GB9c is Unicode 15.1)
+        {u8"\u1100\u1161\u11A8\uAC01", {u8"\u1100\u1161\u11A8", u8"\uAC01"}},    // Jamo L V T, then a syllable
+        {u8"🇩🇪🇫🇷🇺", {u8"🇩🇪", u8"🇫🇷", u8"🇺"}},                              // Regional indicator pairs
+        {u8"👨‍👩‍👧!", {u8"👨‍👩‍👧", "!"}},                                      // ZWJ sequence
+        {u8"👍🏽👍", {u8"👍🏽", u8"👍"}},                                   // Skin tone modifier
+        {u8"a‍👍", {u8"a‍", u8"👍"}},                                     // ZWJ after a non-pictographic
+        {u8"؀a", {u8"؀a"}},                                  // Prepend
+        {std::string("\xFF") + u8"́", {std::string("\xFF") + u8"́"}},    // Invalid byte takes marks like U+FFFD
+    };
+    for (const auto& c : cases) {
+        UTEST_ASSERT_TRUE(split(c.input, graphemes(c.input)) == c.expected);
+        UTEST_ASSERT_EQUALS(c.expected.size(), grapheme_count(c.input));
+    }
+
+    // Character counts of each cluster
+    std::string family = u8"👨‍👩‍👧";
+    auto range = graphemes(family);
+    UTEST_ASSERT_EQUALS(1u, range.size());
+    UTEST_ASSERT_EQUALS(5u, range.begin()->char_count);
+    UTEST_ASSERT_EQUALS(family.length(), range.begin()->byte_count);
+    UTEST_ASSERT_EQUALS(5u, length(family));
+}
+
+// Test grapheme_count against the iterator with ASCII runs of every length around other text
+UTEST_FUNC_DEF2(U8ScanSegmentation, GraphemeCount) {
+    std::vector<std::string> pieces = {u8"é", u8"🇩🇪", u8"👨‍👩‍👧", "\r\n", "\r", u8"́", "\x80", u8"각"};
+    for (std::size_t run = 0; run < 40; ++run) {
+        for (const auto& piece : pieces) {
+            std::string input = std::string(run, 'a') + piece + std::string(run % 7, 'b') + "\r\n" + piece;
+            UTEST_ASSERT_EQUALS(graphemes(input).size(), grapheme_count(input));
+        }
+    }
+    UTEST_ASSERT_EQUALS(100u, grapheme_count(std::string(100, 'x')));
+    std::string lines;
+    for (int i = 0; i < 50; ++i) {
+        lines += "\r\n";
+    }
+    UTEST_ASSERT_EQUALS(50u, grapheme_count(lines));
+
+    // BOM is not counted
+    UTEST_ASSERT_EQUALS(2u, grapheme_count(bom_str() + u8"é!"));
+    UTEST_ASSERT_EQUALS(0u, grapheme_count(bom_str()));
+}
+
+// Test the range with STL algorithms
+UTEST_FUNC_DEF2(U8ScanSegmentation, GraphemeRange) {
+    std::string text = bom_str() + u8"ok 👍🏽 🇩🇪";
+    auto range = graphemes(text);
+    UTEST_ASSERT_EQUALS(3u, range.begin()->start_pos);
+    UTEST_ASSERT_EQUALS(6u, range.size());
+    UTEST_ASSERT_EQUALS(7u, graphemes(text, false).size());
+    auto multi_char = std::count_if(range.begin(), range.end(), [](const Segment& g) { return g.char_count > 1; });
+    UTEST_ASSERT_EQUALS(2, multi_char);
+
+    // Segments are contiguous and cover the string
+    std::size_t pos = 3;
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        UTEST_ASSERT_EQUALS(pos, it.position());
+        UTEST_ASSERT_EQUALS(pos, it->start_pos);
+        pos = it->end_pos();
+    }
+    UTEST_ASSERT_EQUALS(text.length(), pos);
+    UTEST_ASSERT_TRUE(graphemes("").empty());
+}
+
+// Test word boundaries of words, numbers, punctuation and spaces
+UTEST_FUNC_DEF2(U8ScanSegmentation, WordBoundaries) {
+    struct Case { std::string input; std::vector<std::string> expected; };
+    std::vector<Case> cases = {
+        {"", {}},
+        {"Hello, world!", {"Hello", ",", " ", "world", "!"}},
+        {"can't 3.14 e.g. a_b", {"can't", " ", "3.14", " ", "e.g", ".", " ", "a_b"}},
+        {"1,000,000.5 x:y x. 'q'", {"1,000,000.5", " ", "x:y", " ", "x", ".", " ", "'", "q", "'"}},
+        {"a  \t b\r\n\nc", {"a", "  ", "\t", " ", "b", "\r\n", "\n", "c"}},
+        {u8"naïve café", {u8"naïve", " ", u8"café"}},
+        {u8"ét­é", {u8"ét­é"}},             // Marks and format characters are ignored (WB4)
+        {u8"日本語テキスト", {u8"日", u8"本", u8"語", u8"テキスト"}},            // Ideographs break, Katakana joins
+        {u8"א\"ב א'", {u8"א\"ב", " ", u8"א'"}},  // Hebrew quotes (WB7a-WB7c)
+        {u8"🇩🇪🇫🇷", {u8"🇩🇪", u8"🇫🇷"}},                                      // Regional indicator pairs
+        {u8"👨‍👩‍👧 🧑", {u8"👨‍👩‍👧", " ", u8"🧑"}},                                 // Emoji ZWJ sequence (WB3c)
+        {u8"　　x", {u8"　　", "x"}},                         // Spaces join (WB3d)
+        {std::string("ab\xFF") + "cd", {"ab", "\xFF", "cd"}},
+    };
+    for (const auto& c : cases) {
+        UTEST_ASSERT_TRUE(split(c.input, words(c.input)) == c.expected);
+    }
+}
+
+// Test ASCII word runs of every length around punctuation that needs context
+UTEST_FUNC_DEF2(U8ScanSegmentation, WordAsciiRuns) {
+    for (std::size_t run = 1; run < 70; ++run) {
+        std::string word(run, 'w');
+        std::string number(run, '7');
+        std::string text = word + "'s " + number + ".5 " + word + "." + u8"é" + word + " _" + word + "! " + word;
+        std::vector<std::string> expected = {word + "'s", " ", number + ".5", " ", word + u8".é" + word, " ", "_" + word, "!", " ", word};
+        UTEST_ASSERT_TRUE(split(text, words(text)) == expected);
+
+        // Character counts include the ASCII runs
+        auto range = words(text);
+        UTEST_ASSERT_EQUALS(run + 2, range.begin()->char_count);
+    }
+}
+
+// Test selecting words for tokenization
+UTEST_FUNC_DEF2(U8ScanSegmentation, WordTokens) {
+    std::string text = bom_str() + u8"The quick (\"brown\") fox can't jump 32.3 feet, right? ナルト_2";
+    std::vector<std::string> tokens;
+    for (const auto& w : words(text)) {
+        if (is_word_segment(text, w)) {
+            tokens.push_back(text.substr(w.start_pos, w.byte_count));
+        }
+    }
+    std::vector<std::string> expected = {"The", "quick", "brown", "fox", "can't", "jump", "32.3", "feet", "right", u8"ナルト_2"};
+    UTEST_ASSERT_TRUE(tokens == expected);
+    UTEST_ASSERT_EQUALS(3u, words(text).begin()->start_pos);
+}
+
+// Test line break opportunities after spaces, hyphens, ideographs and around numbers
+UTEST_FUNC_DEF2(U8ScanSegmentation, LineBreaks) {
+    struct Case { std::string input; std::vector<std::string> expected; };
+    std::vector<Case> cases = {
+        {"", {}},
+        {"Hello, world! ", {"Hello, ", "world! "}},
+        {"a-b x--y  z", {"a-", "b ", "x--", "y  ", "z"}},
+        {"$(12.50) 50% (a)", {"$(12.50) ", "50% ", "(a)"}},                   // Numbers (LB25)
+        {"line\nnext\r\nlast\x0B" "end", {"line\n", "next\r\n", "last\x0B", "end"}},
+        {u8"日本語です。", {u8"日", u8"本", u8"語", u8"で", u8"す。"}},              // Ideographs break, not before CL
+        {u8"a​b x y⁠z", {u8"a​", "b ", u8"x y⁠z"}},    // ZW, GL, WJ
+        {u8"é ́x", {u8"é ", u8"́x"}},                // Marks attach (LB9) or are AL (LB10)
+        {u8"🇩🇪🇫🇷👍🏽👍", {u8"🇩🇪", u8"🇫🇷", u8"👍🏽", u8"👍"}},                 // LB30a, LB30b
+        {u8"( a(́ b)", {u8"( a(́ b)"}},                  // OP SP* (LB14)
+        {std::string("ab\xFF") + "cd", {"ab\xFF" "cd"}},
+    };
+    for (const auto& c : cases) {
+        UTEST_ASSERT_TRUE(split(c.input, line_breaks(c.input)) == c.expected);
+    }
+
+    std::string text = u8"one\ntwo three ";
+    std::vector<bool> mandatory;
+    for (const auto& s : line_breaks(text)) {
+        mandatory.push_back(is_mandatory_break(text, s));
+    }
+    UTEST_ASSERT_TRUE(mandatory == std::vector<bool>({true, true, false}));
+}
+
+// Test ASCII runs of every length before characters that need context
+UTEST_FUNC_DEF2(U8ScanSegmentation, LineBreakAsciiRuns) {
+    for (std::size_t run = 1; run < 70; ++run) {
+        std::string word(run, 'w');
+        std::string number(run, '7');
+        std::string text = word + "-" + word + " (" + word + u8"́) " + number + "% " + word + u8"日";
+        std::vector<std::string> expected = {word + "-", word + " ", "(" + word + u8"́) ", number + "% ", word, u8"日"};
+        UTEST_ASSERT_TRUE(split(text, line_breaks(text)) == expected);
+        UTEST_ASSERT_EQUALS(run + 1, line_breaks(text).begin()->char_count);
+    }
+}
+
+// Test greedy wrapping to a fixed number of characters
+UTEST_FUNC_DEF2(U8ScanSegmentation, LineWrap) {
+    std::string text = bom_str() + u8"The quick brown fox jumps over the lazy dog.\nÜber 12,5 km weit – ganz schön!";
+    std::vector<std::string> lines;
+    std::string line;
+    std::size_t width = 0;
+    for (const auto& s : line_breaks(text)) {
+        if (width + s.char_count > 16 && !line.empty()) {
+            lines.push_back(line);
+            line.clear();
+            width = 0;
+        }
+        line.append(text, s.start_pos, s.byte_count);
+        width += s.char_count;
+        if (is_mandatory_break(text, s)) {
+            lines.push_back(line);
+            line.clear();
+            width = 0;
+        }
+    }
+    lines.push_back(line);
+    std::vector<std::string> expected = {
+        "The quick brown ", "fox jumps over ", "the lazy dog.\n", u8"Über 12,5 ", u8"km weit – ganz ", u8"schön!"
+    };
+    UTEST_ASSERT_TRUE(lines == expected);
+}
+
+// Main test runner
+int main() {
+    UTEST_PROLOG();
+    UTEST_ENABLE_VERBOSE_MODE();
+
+    // Grapheme cluster tests
+    UTEST_FUNC2(U8ScanSegmentation, GraphemeClusters);
+    UTEST_FUNC2(U8ScanSegmentation, GraphemeCount);
+    UTEST_FUNC2(U8ScanSegmentation, GraphemeRange);
+
+    // Word boundary tests
+    UTEST_FUNC2(U8ScanSegmentation, WordBoundaries);
+    UTEST_FUNC2(U8ScanSegmentation, WordAsciiRuns);
+    UTEST_FUNC2(U8ScanSegmentation, WordTokens);
+
+    // Line break tests
+    UTEST_FUNC2(U8ScanSegmentation, LineBreaks);
+    UTEST_FUNC2(U8ScanSegmentation, LineBreakAsciiRuns);
+    UTEST_FUNC2(U8ScanSegmentation, LineWrap);
+
+    UTEST_EPILOG();
+}
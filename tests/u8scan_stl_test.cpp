@@ -118,6 +118,19 @@ UTEST_FUNC_DEF2(U8ScanSTL, CharIteratorFunctionality) {
     // Test range size
     std::size_t char_count = static_cast<std::size_t>(std::distance(range.begin(), range.end()));
     UTEST_ASSERT_EQUALS(9u, char_count);  // H e l l o (space) 世 界 !
+    
+    // Test copies of dereferenced iterators (copies decode the character again)
+    auto wide = range.begin();
+    std::advance(wide, 6);
+    UTEST_ASSERT_EQUALS(0x4E16u, wide->codepoint);
+    auto copy = wide;
+    UTEST_ASSERT_EQUALS(0x4E16u, copy->codepoint);
+    UTEST_ASSERT_EQUALS(3u, copy->byte_count);
+    auto old = copy++;
+    UTEST_ASSERT_EQUALS(0x4E16u, old->codepoint);
+    UTEST_ASSERT_EQUALS(0x754Cu, copy->codepoint);
+    copy = it;
+    UTEST_ASSERT_EQUALS('e', static_cast<char>(copy->codepoint));
 }
 
 // Run all tests
@@ -0,0 +1,685 @@
+#!/usr/bin/env python3
+"""Generates include/u8scan/u8scan_tables.h from the Unicode Character Database.
+
+Usage:
+    python3 tools/gen_unicode_tables.py --ucd-dir <dir> [-o include/u8scan/u8scan_tables.h]
+
+The directory must contain the UCD files listed in UCD_FILES (the emoji and auxiliary files may
+also be in the emoji/ and auxiliary/ subdirectories, as in the unicode.org layout). All tables are
+two-stage lookups: stage 1 maps a block of code points to a block of values in stage 2, identical
+blocks are shared (binary properties use blocks of 256 bits). Arrays are function-local statics in inline functions, so the header can be
+included from any number of translation units.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+UCD_FILES = [
+    'UnicodeData.txt',
+    'CaseFolding.txt',
+    'DerivedNormalizationProps.txt',
+    'GraphemeBreakProperty.txt',
+    'WordBreakProperty.txt',
+    'LineBreak.txt',
+    'EastAsianWidth.txt',
+    'emoji-data.txt',
+    'Scripts.txt',
+]
+
+# Property values in the order of their numeric values in the generated tables
+GENERAL_CATEGORY_VALUES = [
+    'Cn', 'Lu', 'Ll', 'Lt', 'Lm', 'Lo', 'Mn', 'Mc', 'Me', 'Nd', 'Nl', 'No', 'Pc', 'Pd', 'Ps', 'Pe',
+    'Pi', 'Pf', 'Po', 'Sm', 'Sc', 'Sk', 'So', 'Zs', 'Zl', 'Zp', 'Cc', 'Cf', 'Cs', 'Co',
+]
+
+GRAPHEME_BREAK_VALUES = [
+    'Other', 'CR', 'LF', 'Control', 'Extend', 'ZWJ', 'Regional_Indicator', 'Prepend', 'SpacingMark',
+    'L', 'V', 'T', 'LV', 'LVT', 'Extended_Pictographic',
+]
+
+WORD_BREAK_VALUES = [
+    'Other', 'CR', 'LF', 'Newline', 'Extend', 'ZWJ', 'Regional_Indicator', 'Format', 'Katakana',
+    'Hebrew_Letter', 'ALetter', 'Single_Quote', 'Double_Quote', 'MidNumLet', 'MidLetter', 'MidNum',
+    'Numeric', 'ExtendNumLet', 'WSegSpace',
+]
+
+# Line_Break values after the UAX #14 LB1 resolution (AI, SG, XX -> AL, SA -> CM or AL, CJ -> NS)
+LINE_BREAK_VALUES = [
+    'AL', 'BK', 'CR', 'LF', 'NL', 'SP', 'ZW', 'WJ', 'GL', 'CB', 'CM', 'ZWJ', 'OP', 'CL', 'CP', 'QU',
+    'EX', 'IS', 'SY', 'NS', 'B2', 'BA', 'BB', 'HY', 'HL', 'IN', 'NU', 'PR', 'PO', 'ID', 'EB', 'EM',
+    'JL', 'JV', 'JT', 'H2', 'H3', 'RI',
+]
+
+
+# ---------------------------------------------------------------------------
+# UCD parsing
+# ---------------------------------------------------------------------------
+
+def find_ucd_file(ucd_dir, name):
+    for sub in ('', 'auxiliary', 'emoji', 'extracted'):
+        path = os.path.join(ucd_dir, sub, name)
+        if os.path.exists(path):
+            return path
+    sys.exit('error: %s not found in %s' % (name, ucd_dir))
+
+
+def read_unicode_data(ucd_dir):
+    """Returns {codepoint: fields} from UnicodeData.txt, with First/Last ranges expanded."""
+    entries = {}
+    range_start = None
+    with open(find_ucd_file(ucd_dir, 'UnicodeData.txt'), encoding='utf-8') as f:
+        for line in f:
+            fields = line.rstrip('\n').split(';')
+            if len(fields) < 15:
+                continue
+            cp = int(fields[0], 16)
+            if fields[1].endswith(', First>'):
+                range_start = cp
+                continue
+            if fields[1].endswith(', Last>'):
+                for c in range(range_start, cp + 1):
+                    entries[c] = fields
+                range_start = None
+                continue
+            entries[cp] = fields
+    return entries
+
+
+def read_case_folding(ucd_dir):
+    """Returns ({cp: simple folding}, {cp: [full folding]}) from CaseFolding.txt (statuses C+S and F)."""
+    simple = {}
+    full = {}
+    with open(find_ucd_file(ucd_dir, 'CaseFolding.txt'), encoding='utf-8') as f:
+        for line in f:
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            code, status, mapping = [x.strip() for x in line.split(';')[:3]]
+            cp = int(code, 16)
+            targets = [int(x, 16) for x in mapping.split()]
+            if status in ('C', 'S'):
+                simple[cp] = targets[0]
+            elif status == 'F':
+                full[cp] = targets
+    return simple, full
+
+
+def read_property_file(ucd_dir, name):
+    """Yields (first, last, [fields]) for each 'XXXX..YYYY ; field ; ...' line of a UCD property file."""
+    with open(find_ucd_file(ucd_dir, name), encoding='utf-8') as f:
+        for line in f:
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            fields = [x.strip() for x in line.split(';')]
+            first, _, last = fields[0].partition('..')
+            yield int(first, 16), int(last or first, 16), fields[1:]
+
+
+def read_enumerated_property(ucd_dir, name, values, prop=None):
+    """Returns {cp: value index} from a property file, either for 'cp ; Value' lines or for the
+    'cp ; Property' lines of the binary property prop (mapped to the value index of prop)."""
+    result = {}
+    for first, last, fields in read_property_file(ucd_dir, name):
+        if prop is not None and fields[0] != prop:
+            continue
+        value = values.index(fields[0])
+        for cp in range(first, last + 1):
+            result[cp] = value
+    return result
+
+
+def read_version(ucd_dir):
+    """Unicode version from the header line of a UCD property file, e.g. '# CaseFolding-14.0.0.txt'."""
+    for name in UCD_FILES:
+        with open(find_ucd_file(ucd_dir, name), encoding='utf-8') as f:
+            match = re.search(r'-(\d+)\.(\d+)\.(\d+)\.txt', f.readline())
+        if match:
+            return match.groups()
+    return None
+
+
+# ---------------------------------------------------------------------------
+# Table emission
+# ---------------------------------------------------------------------------
+
+def c_type(max_value, signed=False):
+    if signed:
+        for bits in (8, 16, 32):
+            if max_value < (1 << (bits - 1)):
+                return 'int%d_t' % bits
+    for bits in (8, 16, 32):
+        if max_value < (1 << bits):
+            return 'uint%d_t' % bits
+    raise ValueError('value out of range: %d' % max_value)
+
+
+def format_array(values, per_line=24):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append('        ' + ', '.join(str(v) for v in values[i:i + per_line]) + ',')
+    return '\n'.join(lines)
+
+
+def type_size(c_type_name):
+    return int(re.search(r'\d+', c_type_name).group(0)) // 8
+
+
+def two_stage(values, default):
+    """Splits a dense {cp: value} mapping into (shift, stage1, stage2) with the smallest total size."""
+    last = max([cp for cp, v in values.items() if v != default] or [0])
+    best = None
+    for shift in range(4, 10):
+        block_count = (last >> shift) + 1
+        blocks = {}
+        stage1 = []
+        stage2 = []
+        for b in range(block_count):
+            content = tuple(values.get(cp, default) for cp in range(b << shift, (b + 1) << shift))
+            if content not in blocks:
+                blocks[content] = len(blocks)
+                stage2.extend(content)
+            stage1.append(blocks[content])
+        size = len(stage1) * type_size(c_type(len(blocks) - 1)) + len(stage2) * type_size(c_type(max(stage2)))
+        if best is None or size < best[0]:
+            best = (size, shift, stage1, stage2)
+    return best[1:]
+
+
+def emit_lookup(out, name, values, default, doc):
+    """Emits `inline T name(uint32_t cp)` returning values[cp] (default if not present)."""
+    shift, stage1, stage2 = two_stage(values, default)
+    value_type = c_type(max(stage2 + [default]))
+    index_type = c_type(max(stage1))
+    limit = len(stage1) << shift
+    out.append('/**')
+    out.append(' * @brief %s' % doc)
+    out.append(' */')
+    out.append('inline %s %s(uint32_t cp) {' % (value_type, name))
+    out.append('    static const %s stage1[%d] = {' % (index_type, len(stage1)))
+    out.append(format_array(stage1))
+    out.append('    };')
+    out.append('    static const %s stage2[%d] = {' % (value_type, len(stage2)))
+    out.append(format_array(stage2))
+    out.append('    };')
+    out.append('    if (cp >= 0x%X) {' % limit)
+    out.append('        return %d;' % default)
+    out.append('    }')
+    out.append('    return stage2[(static_cast<uint32_t>(stage1[cp >> %d]) << %d) | (cp & 0x%X)];' % (shift, shift, (1 << shift) - 1))
+    out.append('}')
+    out.append('')
+
+
+def emit_bitset(out, name, members, doc):
+    """Emits `inline bool name(uint32_t cp)` for a set of code points, as a two-stage bitset with
+    a stage 1 entry per 256 code points and four 64-bit words per distinct block in stage 2."""
+    limit = ((max(members) >> 8) + 1) << 8
+    blocks = {}
+    stage1 = []
+    stage2 = []
+    for base in range(0, limit, 256):
+        words = tuple(sum(1 << i for i in range(64) if base + w * 64 + i in members) for w in range(4))
+        if words not in blocks:
+            blocks[words] = len(blocks)
+            stage2.extend(words)
+        stage1.append(blocks[words])
+    out.append('/**')
+    out.append(' * @brief %s' % doc)
+    out.append(' */')
+    out.append('inline bool %s(uint32_t cp) {' % name)
+    out.append('    static const %s stage1[%d] = {' % (c_type(max(stage1)), len(stage1)))
+    out.append(format_array(stage1))
+    out.append('    };')
+    out.append('    static const uint64_t stage2[%d] = {' % len(stage2))
+    out.append(format_array(['0x%016XULL' % w for w in stage2], 4))
+    out.append('    };')
+    out.append('    if (cp >= 0x%X) {' % limit)
+    out.append('        return false;')
+    out.append('    }')
+    out.append('    return ((stage2[(static_cast<uint32_t>(stage1[cp >> 8]) << 2) | ((cp >> 6) & 3)] >> (cp & 63)) & 1) != 0;')
+    out.append('}')
+    out.append('')
+
+
+def emit_constants(out, prefix, values, doc):
+    """Emits one `static const uint8_t` per property value, e.g. grapheme_regional_indicator."""
+    out.append('/// %s' % doc)
+    for index, value in enumerate(values):
+        name = re.sub(r'(?<=[a-z])(?=[A-Z])', '_', value).lower()
+        out.append('static const uint8_t %s_%s = %d;' % (prefix, name, index))
+    out.append('')
+
+
+def emit_class_table(out, name, struct_name, rows, doc):
+    """Emits a table of distinct rows indexed by a class number."""
+    out.append('/**')
+    out.append(' * @brief %s' % doc)
+    out.append(' */')
+    out.append('inline const %s& %s(unsigned index) {' % (struct_name, name))
+    out.append('    static const %s rows[%d] = {' % (struct_name, len(rows)))
+    for row in rows:
+        out.append('        {%s},' % ', '.join(str(v) for v in row))
+    out.append('    };')
+    out.append('    return rows[index];')
+    out.append('}')
+    out.append('')
+
+
+# ---------------------------------------------------------------------------
+# Properties
+# ---------------------------------------------------------------------------
+
+def gen_case_mapping(out, unicode_data, simple_folding, full_folding):
+    """Simple case mappings and simple case folding stored as deltas, shared between code points.
+
+    Full case foldings (one-to-many, e.g. U+00DF -> ss) are flagged in the rows and kept in a
+    separate sorted table.
+    """
+    rows = [(0, 0, 0, 'false')]
+    row_index = {rows[0]: 0}
+    classes = {}
+    for cp in sorted(set(unicode_data) | set(simple_folding) | set(full_folding)):
+        fields = unicode_data.get(cp)
+        upper = int(fields[12], 16) - cp if fields and fields[12] else 0
+        lower = int(fields[13], 16) - cp if fields and fields[13] else 0
+        fold = simple_folding.get(cp, cp) - cp
+        row = (lower, upper, fold, 'true' if cp in full_folding else 'false')
+        if row == rows[0]:
+            continue
+        if row not in row_index:
+            row_index[row] = len(rows)
+            rows.append(row)
+        classes[cp] = row_index[row]
+    if len(rows) > 256:
+        sys.exit('error: too many case mapping classes')
+
+    out.append('struct CaseDeltas {')
+    out.append('    int32_t lower;      ///< Simple_Lowercase_Mapping minus the code point')
+    out.append('    int32_t upper;      ///< Simple_Uppercase_Mapping minus the code point')
+    out.append('    int32_t fold;       ///< Simple_Case_Folding minus the code point')
+    out.append('    bool full_fold;     ///< Full case folding maps to several code points, see full_case_folding()')
+    out.append('};')
+    out.append('')
+    emit_lookup(out, 'case_class', classes, 0, 'Index into case_deltas() for a code point, 0 if it has no case mapping or folding')
+    emit_class_table(out, 'case_deltas', 'CaseDeltas', rows, 'Case mapping deltas by case_class()')
+
+    out.append('struct FullCaseFolding {')
+    out.append('    uint32_t cp;')
+    out.append('    uint32_t folded[3];     ///< Zero-terminated if shorter than 3')
+    out.append('};')
+    out.append('')
+    out.append('/**')
+    out.append(' * @brief Full case folding of a code point flagged with CaseDeltas::full_fold, nullptr if there is none')
+    out.append(' */')
+    out.append('inline const FullCaseFolding* full_case_folding(uint32_t cp) {')
+    out.append('    static const FullCaseFolding entries[%d] = {' % len(full_folding))
+    for cp in sorted(full_folding):
+        folded = full_folding[cp] + [0] * (3 - len(full_folding[cp]))
+        out.append('        {0x%04X, {%s}},' % (cp, ', '.join('0x%04X' % x for x in folded)))
+    out.append('    };')
+    out.append('    std::size_t low = 0;')
+    out.append('    std::size_t high = %d;' % len(full_folding))
+    out.append('    while (low < high) {')
+    out.append('        std::size_t mid = (low + high) / 2;')
+    out.append('        if (entries[mid].cp < cp) {')
+    out.append('            low = mid + 1;')
+    out.append('        } else {')
+    out.append('            high = mid;')
+    out.append('        }')
+    out.append('    }')
+    out.append('    return low < %d && entries[low].cp == cp ? &entries[low] : nullptr;' % len(full_folding))
+    out.append('}')
+    out.append('')
+
+
+def gen_general_category(out, unicode_data):
+    """General_Category from UnicodeData.txt; unassigned code points are Cn."""
+    values = {}
+    for cp, fields in unicode_data.items():
+        value = GENERAL_CATEGORY_VALUES.index(fields[2])
+        if value:
+            values[cp] = value
+
+    emit_constants(out, 'category', GENERAL_CATEGORY_VALUES, 'general_category() values: General_Category')
+    emit_lookup(out, 'general_category', values, 0, 'General_Category of a code point, see the category_* values')
+
+
+def gen_normalization(out, unicode_data, ucd_dir):
+    """Canonical combining classes, quick check flags, decomposition mappings and composition pairs.
+
+    Decompositions are stored as in UnicodeData.txt (one level, expanded recursively at run time);
+    Hangul syllables are decomposed and composed algorithmically and are not in the tables.
+    """
+    combining = {cp: int(fields[3]) for cp, fields in unicode_data.items() if fields[3] != '0'}
+    flags = {}
+    bits = {('NFD_QC', 'N'): 1, ('NFKD_QC', 'N'): 2, ('NFC_QC', 'M'): 4, ('NFC_QC', 'N'): 8,
+            ('NFKC_QC', 'M'): 16, ('NFKC_QC', 'N'): 32}
+    exclusions = set()
+    for first, last, fields in read_property_file(ucd_dir, 'DerivedNormalizationProps.txt'):
+        for cp in range(first, last + 1):
+            if fields[0] == 'Full_Composition_Exclusion':
+                exclusions.add(cp)
+            elif len(fields) > 1 and (fields[0], fields[1]) in bits:
+                flags[cp] = flags.get(cp, 0) | bits[(fields[0], fields[1])]
+
+    data = [0]
+    sequences = {}
+    rows = [(0, 0, 'false')]
+    row_index = {rows[0]: 0}
+    decomposition = {}
+    pairs = []
+    for cp in sorted(unicode_data):
+        mapping = unicode_data[cp][5]
+        if not mapping or unicode_data[cp][1].endswith('>'):
+            continue
+        compatibility = mapping.startswith('<')
+        targets = tuple(int(x, 16) for x in mapping.split('>')[-1].split())
+        if targets not in sequences:
+            sequences[targets] = len(data)
+            data.extend(targets)
+        row = (sequences[targets], len(targets), 'true' if compatibility else 'false')
+        if row not in row_index:
+            row_index[row] = len(rows)
+            rows.append(row)
+        decomposition[cp] = row_index[row]
+        if not compatibility and len(targets) == 2 and cp not in exclusions:
+            pairs.append((targets[0], targets[1], cp))
+    pairs.sort()
+
+    out.append('/// quick_check() flags: the code point cannot occur in (NO) or needs context (MAYBE) in a normalization form')
+    out.append('static const uint8_t quick_check_nfd_no = 1;')
+    out.append('static const uint8_t quick_check_nfkd_no = 2;')
+    out.append('static const uint8_t quick_check_nfc_maybe = 4;')
+    out.append('static const uint8_t quick_check_nfc_no = 8;')
+    out.append('static const uint8_t quick_check_nfkc_maybe = 16;')
+    out.append('static const uint8_t quick_check_nfkc_no = 32;')
+    out.append('')
+    emit_lookup(out, 'combining_class', combining, 0, 'Canonical_Combining_Class of a code point')
+    emit_lookup(out, 'quick_check', flags, 0, 'NFD/NFKD/NFC/NFKC_Quick_Check flags of a code point')
+
+    out.append('struct Decomposition {')
+    out.append('    uint16_t offset;        ///< Start of the mapping in decomposition_data()')
+    out.append('    uint8_t length;')
+    out.append('    bool compatibility;     ///< Compatibility mapping, only applied for NFKD and NFKC')
+    out.append('};')
+    out.append('')
+    out.append('/**')
+    out.append(' * @brief Code points of all decomposition mappings')
+    out.append(' */')
+    out.append('inline const uint32_t* decomposition_data() {')
+    out.append('    static const uint32_t data[%d] = {' % len(data))
+    out.append(format_array(data, 16))
+    out.append('    };')
+    out.append('    return data;')
+    out.append('}')
+    out.append('')
+    emit_lookup(out, 'decomposition_index', decomposition, 0, 'Index into decompositions() for a code point, 0 if it has no decomposition mapping')
+    emit_class_table(out, 'decompositions', 'Decomposition', rows, 'Decomposition mappings by decomposition_index()')
+
+    out.append('struct CompositionPair {')
+    out.append('    uint32_t first;')
+    out.append('    uint32_t second;')
+    out.append('    uint32_t composite;')
+    out.append('};')
+    out.append('')
+    out.append('/**')
+    out.append(' * @brief Primary composite of two code points, 0 if there is none')
+    out.append(' */')
+    out.append('inline uint32_t compose_pair(uint32_t first, uint32_t second) {')
+    out.append('    static const CompositionPair pairs[%d] = {' % len(pairs))
+    for first, second, composite in pairs:
+        out.append('        {0x%04X, 0x%04X, 0x%04X},' % (first, second, composite))
+    out.append('    };')
+    out.append('    std::size_t low = 0;')
+    out.append('    std::size_t high = %d;' % len(pairs))
+    out.append('    while (low < high) {')
+    out.append('        std::size_t mid = (low + high) / 2;')
+    out.append('        if (pairs[mid].first < first || (pairs[mid].first == first && pairs[mid].second < second)) {')
+    out.append('            low = mid + 1;')
+    out.append('        } else {')
+    out.append('            high = mid;')
+    out.append('        }')
+    out.append('    }')
+    out.append('    return low < %d && pairs[low].first == first && pairs[low].second == second ? pairs[low].composite : 0;' % len(pairs))
+    out.append('}')
+    out.append('')
+
+
+def gen_grapheme_break(out, ucd_dir):
+    """Grapheme_Cluster_Break with Extended_Pictographic folded in as an extra value (UAX #29 GB11).
+
+    Extended_Pictographic code points all have Grapheme_Cluster_Break=Other.
+    """
+    values = read_enumerated_property(ucd_dir, 'GraphemeBreakProperty.txt', GRAPHEME_BREAK_VALUES)
+    pictographic = read_enumerated_property(ucd_dir, 'emoji-data.txt', GRAPHEME_BREAK_VALUES, 'Extended_Pictographic')
+    for cp, value in pictographic.items():
+        if cp in values:
+            sys.exit('error: Extended_Pictographic U+%04X has Grapheme_Cluster_Break %s' % (cp, GRAPHEME_BREAK_VALUES[values[cp]]))
+        values[cp] = value
+
+    emit_constants(out, 'grapheme', GRAPHEME_BREAK_VALUES, 'grapheme_break() values: Grapheme_Cluster_Break, plus Extended_Pictographic')
+    emit_lookup(out, 'grapheme_break', values, 0, 'Grapheme_Cluster_Break of a code point, see the grapheme_* values')
+
+
+def gen_word_break(out, ucd_dir):
+    """Word_Break, with a flag bit for Extended_Pictographic (UAX #29 WB3c), which is not exclusive."""
+    values = read_enumerated_property(ucd_dir, 'WordBreakProperty.txt', WORD_BREAK_VALUES)
+    flag = 0x20
+    for first, last, fields in read_property_file(ucd_dir, 'emoji-data.txt'):
+        if fields[0] == 'Extended_Pictographic':
+            for cp in range(first, last + 1):
+                values[cp] = values.get(cp, 0) | flag
+
+    emit_constants(out, 'word', WORD_BREAK_VALUES, 'word_break() values: Word_Break')
+    out.append('/// word_break() flag for Extended_Pictographic, combined with the Word_Break value')
+    out.append('static const uint8_t word_extended_pictographic = 0x%02X;' % flag)
+    out.append('')
+    emit_lookup(out, 'word_break', values, 0, 'Word_Break of a code point, see the word_* values')
+
+
+def gen_line_break(out, unicode_data, ucd_dir):
+    """Line_Break resolved per UAX #14 LB1, with flag bits for the context of LB30 and LB30b."""
+    east_asian = set()
+    for first, last, fields in read_property_file(ucd_dir, 'EastAsianWidth.txt'):
+        if fields[0] in ('F', 'W', 'H'):
+            east_asian.update(range(first, last + 1))
+    pictographic = set()
+    for first, last, fields in read_property_file(ucd_dir, 'emoji-data.txt'):
+        if fields[0] == 'Extended_Pictographic':
+            pictographic.update(range(first, last + 1))
+
+    east_asian_flag = 0x40
+    unassigned_pictographic_flag = 0x80
+    values = {}
+    for first, last, fields in read_property_file(ucd_dir, 'LineBreak.txt'):
+        for cp in range(first, last + 1):
+            value = fields[0]
+            if value in ('AI', 'SG', 'XX'):
+                value = 'AL'
+            elif value == 'SA':
+                value = 'CM' if cp in unicode_data and unicode_data[cp][2] in ('Mn', 'Mc') else 'AL'
+            elif value == 'CJ':
+                value = 'NS'
+            value = LINE_BREAK_VALUES.index(value)
+            if value in (LINE_BREAK_VALUES.index('OP'), LINE_BREAK_VALUES.index('CP')) and cp in east_asian:
+                value |= east_asian_flag
+            if cp in pictographic and cp not in unicode_data:
+                value |= unassigned_pictographic_flag
+            if value:
+                values[cp] = value
+
+    emit_constants(out, 'line', LINE_BREAK_VALUES, 'line_break() values: Line_Break after the UAX #14 LB1 resolution')
+    out.append('/// line_break() flag for OP and CP with East_Asian_Width F, W or H (UAX #14 LB30)')
+    out.append('static const uint8_t line_east_asian = 0x%02X;' % east_asian_flag)
+    out.append('/// line_break() flag for unassigned Extended_Pictographic code points (UAX #14 LB30b)')
+    out.append('static const uint8_t line_unassigned_pictographic = 0x%02X;' % unassigned_pictographic_flag)
+    out.append('')
+    emit_lookup(out, 'line_break', values, 0, 'Line_Break of a code point, see the line_* values and flags')
+
+
+def gen_display_width(out, unicode_data, ucd_dir):
+    """Terminal column width: 2 for East_Asian_Width W and F, 0 for marks, invisible format and
+    control characters and conjoining Hangul vowels and final consonants, 1 otherwise. A flag bit marks
+    text-default emoji that become wide with U+FE0F (emoji presentation selector)."""
+    values = {}
+    for first, last, fields in read_property_file(ucd_dir, 'EastAsianWidth.txt'):
+        if fields[0] in ('W', 'F'):
+            for cp in range(first, last + 1):
+                values[cp] = 2
+    # Visible format characters: soft hyphen and the prepended concatenation marks (Cf with
+    # Grapheme_Cluster_Break=Prepend, e.g. U+0600 ARABIC NUMBER SIGN)
+    grapheme = read_enumerated_property(ucd_dir, 'GraphemeBreakProperty.txt', GRAPHEME_BREAK_VALUES)
+    prepend = GRAPHEME_BREAK_VALUES.index('Prepend')
+    for cp, fields in unicode_data.items():
+        visible = cp == 0x00AD or grapheme.get(cp) == prepend
+        zero = fields[2] in ('Mn', 'Me', 'Cc') or (fields[2] == 'Cf' and not visible)
+        if zero or 0x1160 <= cp <= 0x11FF or 0xD7B0 <= cp <= 0xD7FF:
+            values[cp] = 0
+        elif cp not in values:
+            values[cp] = 1
+
+    emoji = set()
+    presentation = set()
+    for first, last, fields in read_property_file(ucd_dir, 'emoji-data.txt'):
+        if fields[0] == 'Emoji':
+            emoji.update(range(first, last + 1))
+        elif fields[0] == 'Emoji_Presentation':
+            presentation.update(range(first, last + 1))
+    flag = 0x04
+    for cp in emoji - presentation:
+        if values.get(cp, 1) == 1:
+            values[cp] = 1 | flag
+
+    out.append('/// column_width() flag for emoji with text presentation, which are 2 columns wide with U+FE0F')
+    out.append('static const uint8_t width_emoji_text_presentation = 0x%02X;' % flag)
+    out.append('')
+    emit_lookup(out, 'column_width', values, 1, 'Columns (0, 1 or 2) of a code point in a terminal, with the width_emoji_text_presentation flag')
+
+
+def gen_emoji(out, ucd_dir):
+    """Emoji for counting: Extended_Pictographic and Emoji_Presentation (which adds the regional
+    indicators and skin tone modifiers), without the copyright, registered and trade mark signs,
+    which are text symbols unless followed by U+FE0F."""
+    members = set()
+    for first, last, fields in read_property_file(ucd_dir, 'emoji-data.txt'):
+        if fields[0] in ('Extended_Pictographic', 'Emoji_Presentation'):
+            members.update(range(first, last + 1))
+    members -= {0x00A9, 0x00AE, 0x2122}
+    emit_bitset(out, 'is_emoji', members, 'Extended_Pictographic or Emoji_Presentation, except U+00A9, U+00AE and U+2122')
+
+
+def read_scripts(ucd_dir):
+    """Returns (names, {cp: value index}) from Scripts.txt. Unknown, Common and Inherited come
+    first, the other scripts follow in alphabetical order; unlisted code points are Unknown."""
+    ranges = list(read_property_file(ucd_dir, 'Scripts.txt'))
+    special = ['Unknown', 'Common', 'Inherited']
+    names = special + sorted(set(fields[0] for _, _, fields in ranges) - set(special))
+    values = {}
+    for first, last, fields in ranges:
+        value = names.index(fields[0])
+        for cp in range(first, last + 1):
+            values[cp] = value
+    return names, values
+
+
+def gen_script_enum(out, names):
+    """The public Script enumeration, emitted outside the details namespace."""
+    out.append('/**')
+    out.append(' * @brief Unicode Script property values (UAX #24), see script()')
+    out.append(' *')
+    out.append(' * Unknown, Common and Inherited come first, the other scripts follow in alphabetical order.')
+    out.append(' */')
+    out.append('enum class Script : uint8_t {')
+    for index, name in enumerate(names):
+        out.append('    %s%s' % (name, ',' if index + 1 < len(names) else ''))
+    out.append('};')
+    out.append('')
+
+
+def gen_script(out, names, values):
+    """Script lookup, number of values and long value names."""
+    out.append('/// Number of Script values')
+    out.append('static const std::size_t script_count = %d;' % len(names))
+    out.append('')
+    emit_lookup(out, 'script', values, 0, 'Script of a code point, as the index of its Script value')
+    out.append('/**')
+    out.append(' * @brief Long name of a Script value, e.g. "Latin"')
+    out.append(' */')
+    out.append('inline const char* script_name(std::size_t index) {')
+    out.append('    static const char* const names[%d] = {' % len(names))
+    for i in range(0, len(names), 6):
+        out.append('        ' + ' '.join('"%s",' % name for name in names[i:i + 6]))
+    out.append('    };')
+    out.append('    return index < %d ? names[index] : names[0];' % len(names))
+    out.append('}')
+    out.append('')
+
+
+# ---------------------------------------------------------------------------
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--ucd-dir', required=True, help='directory with the UCD files')
+    parser.add_argument('--unicode-version', help='UCD version, e.g. 14.0.0 (default: read from the file headers)')
+    parser.add_argument('-o', '--output', help='output header (default: stdout)')
+    args = parser.parse_args()
+
+    for name in UCD_FILES:
+        find_ucd_file(args.ucd_dir, name)
+    version = tuple(args.unicode_version.split('.')) if args.unicode_version else read_version(args.ucd_dir)
+    if not version or len(version) != 3:
+        sys.exit('error: cannot determine the Unicode version, use --unicode-version')
+    unicode_data = read_unicode_data(args.ucd_dir)
+    simple_folding, full_folding = read_case_folding(args.ucd_dir)
+    script_names, script_values = read_scripts(args.ucd_dir)
+
+    out = []
+    out.append('// Generated by tools/gen_unicode_tables.py from the Unicode Character Database %s. Do not edit.' % '.'.join(version))
+    out.append('')
+    out.append('#ifndef U8SCAN_TABLES_H')
+    out.append('#define U8SCAN_TABLES_H')
+    out.append('')
+    out.append('#include <cstddef>')
+    out.append('#include <cstdint>')
+    out.append('')
+    out.append('namespace u8scan {')
+    out.append('')
+    gen_script_enum(out, script_names)
+    out.append('namespace details {')
+    out.append('namespace ucd {')
+    out.append('')
+    major, minor, patch = version
+    out.append('/// Version of the Unicode Character Database the tables were generated from')
+    out.append('static const unsigned unicode_version_major = %s;' % major)
+    out.append('static const unsigned unicode_version_minor = %s;' % minor)
+    out.append('static const unsigned unicode_version_update = %s;' % patch)
+    out.append('')
+
+    gen_general_category(out, unicode_data)
+    gen_case_mapping(out, unicode_data, simple_folding, full_folding)
+    gen_normalization(out, unicode_data, args.ucd_dir)
+    gen_grapheme_break(out, args.ucd_dir)
+    gen_word_break(out, args.ucd_dir)
+    gen_line_break(out, unicode_data, args.ucd_dir)
+    gen_display_width(out, unicode_data, args.ucd_dir)
+    gen_emoji(out, args.ucd_dir)
+    gen_script(out, script_names, script_values)
+
+    out.append('} // namespace ucd')
+    out.append('} // namespace details')
+    out.append('} // namespace u8scan')
+    out.append('')
+    out.append('#endif // U8SCAN_TABLES_H')
+
+    text = '\n'.join(out) + '\n'
+    if args.output:
+        with open(args.output, 'w', encoding='utf-8', newline='\n') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()